@@ -17,7 +17,8 @@
     m(int32_type, int32_t) \
     m(int64_type, int64_t) \
     m(uint32_type, uint32_t) \
-    m(uint64_type, uint64_t)
+    m(uint64_type, uint64_t) \
+    m(bf16_type, bf16)
 // clang-format on
 
 #ifdef __cplusplus
@@ -299,6 +300,10 @@ migraphx_status migraphx_program_run(migraphx_arguments_t* out,
                                      migraphx_program_t program,
                                      migraphx_program_parameters_t params);
 
+migraphx_status migraphx_program_trace(migraphx_program_t program,
+                                       migraphx_program_parameters_t params,
+                                       const char* filename);
+
 migraphx_status
 migraphx_program_equal(bool* out, const_migraphx_program_t program, const_migraphx_program_t x);
 
@@ -410,6 +415,11 @@ migraphx_status migraphx_quantize_fp16_with_op_names(migraphx_program_t prog,
 
 migraphx_status migraphx_quantize_fp16(migraphx_program_t prog);
 
+migraphx_status migraphx_quantize_bf16_with_op_names(migraphx_program_t prog,
+                                                     migraphx_quantize_op_names_t name);
+
+migraphx_status migraphx_quantize_bf16(migraphx_program_t prog);
+
 migraphx_status
 migraphx_quantize_int8_options_destroy(migraphx_quantize_int8_options_t quantize_int8_options);
 
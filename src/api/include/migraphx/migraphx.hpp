@@ -853,6 +853,12 @@ struct program : MIGRAPHX_HANDLE_BASE(program)
         return arguments(pout, own{});
     }
 
+    /// Run the program and write the time of each instruction to a chrome trace file
+    void trace(const program_parameters& pparams, const char* filename)
+    {
+        call(&migraphx_program_trace, this->get_handle_ptr(), pparams.get_handle_ptr(), filename);
+    }
+
     void print() const { call(&migraphx_program_print, this->get_handle_ptr()); }
 
     program sort()
@@ -1093,6 +1099,18 @@ inline void quantize_fp16(const program& prog)
     call(&migraphx_quantize_fp16, prog.get_handle_ptr());
 }
 
+/// Quantize program to use bf16
+inline void quantize_bf16(const program& prog, const quantize_op_names& names)
+{
+    call(&migraphx_quantize_bf16_with_op_names, prog.get_handle_ptr(), names.get_handle_ptr());
+}
+
+/// Quantize program to use bf16
+inline void quantize_bf16(const program& prog)
+{
+    call(&migraphx_quantize_bf16, prog.get_handle_ptr());
+}
+
 /// Options to be passed when quantizing for int8
 struct quantize_int8_options : MIGRAPHX_HANDLE_BASE(quantize_int8_options)
 {
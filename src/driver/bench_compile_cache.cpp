@@ -0,0 +1,32 @@
+#include "bench_compile_cache.hpp"
+
+#include <migraphx/time.hpp>
+#include <migraphx/tmp_dir.hpp>
+#include <chrono>
+#include <cstdlib>
+
+namespace migraphx {
+namespace driver {
+inline namespace MIGRAPHX_INLINE_NS {
+
+// Compares compiling a program with an empty compile cache against loading it from the cache. The
+// cache directory is read once per process, so this must run before anything else is compiled.
+void bench_compile_cache(std::ostream& os,
+                         const std::function<program()>& load,
+                         const target& t,
+                         const compile_options& options)
+{
+    tmp_dir td{"bench_compile_cache"};
+    setenv("MIGRAPHX_COMPILE_CACHE_DIR", td.path.string().c_str(), 1); // NOLINT
+    auto compile = [&] {
+        auto p = load();
+        return time<std::chrono::duration<double, std::milli>>([&] { p.compile(t, options); });
+    };
+    auto cold = compile();
+    auto warm = compile();
+    os << "Compile: " << cold << "ms, from cache: " << warm << "ms" << std::endl;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace driver
+} // namespace migraphx
@@ -0,0 +1,24 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_BENCH_COMPILE_CACHE_HPP
+#define MIGRAPHX_GUARD_RTGLIB_BENCH_COMPILE_CACHE_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/compile_options.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/target.hpp>
+#include <functional>
+#include <ostream>
+
+namespace migraphx {
+namespace driver {
+inline namespace MIGRAPHX_INLINE_NS {
+
+void bench_compile_cache(std::ostream& os,
+                         const std::function<program()>& load,
+                         const target& t,
+                         const compile_options& options);
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace driver
+} // namespace migraphx
+
+#endif
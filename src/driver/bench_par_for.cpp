@@ -0,0 +1,84 @@
+#include "bench_par_for.hpp"
+
+#include <migraphx/par_for.hpp>
+#include <migraphx/thread_pool.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+namespace migraphx {
+namespace driver {
+inline namespace MIGRAPHX_INLINE_NS {
+
+using bench_clock = std::chrono::steady_clock;
+
+// Compares the latency of dispatching a small parallel loop with a thread per task, which is
+// what par_for did before, against dispatching it to the global pool
+static void bench_dispatch_latency(std::ostream& os, std::size_t iters)
+{
+    const std::size_t threads = thread_pool::global().size();
+    std::vector<std::size_t> data(threads);
+    auto time = [&](auto f) {
+        f();
+        auto start = bench_clock::now();
+        for(std::size_t i = 0; i < iters; i++)
+            f();
+        std::chrono::duration<double, std::micro> d = bench_clock::now() - start;
+        return d.count() / iters;
+    };
+    auto spawn = time([&] {
+        std::vector<joinable_thread> ts;
+        for(std::size_t tid = 0; tid < threads; tid++)
+            ts.emplace_back([&, tid] { data[tid]++; });
+    });
+    auto pool = time([&] { par_for_impl(threads, threads, [&](auto i) { data[i]++; }); });
+    os << "par_for dispatch of " << threads << " tasks: spawn " << spawn << "us, pool " << pool
+       << "us" << std::endl;
+}
+
+// Compares splitting an imbalanced loop into one static piece per thread against letting the
+// pool balance it. The cost of an index grows with the index, as with the border windows of a
+// convolution or ragged regions of interest.
+static void bench_imbalanced(std::ostream& os)
+{
+    const std::size_t n       = 256;
+    const std::size_t threads = thread_pool::global().size();
+    std::vector<double> data(n);
+    auto work = [&](std::size_t i) {
+        double x = 0;
+        for(std::size_t j = 0; j < i * 64; j++)
+            x += std::sqrt(static_cast<double>(j));
+        data[i] = x;
+    };
+    auto time = [&](auto f) {
+        auto start = bench_clock::now();
+        f();
+        std::chrono::duration<double, std::milli> d = bench_clock::now() - start;
+        return d.count();
+    };
+    auto static_split = time([&] {
+        const std::size_t grain = (n + threads - 1) / threads;
+        std::vector<joinable_thread> ts;
+        for(std::size_t start = 0; start < n; start += grain)
+        {
+            ts.emplace_back([&, start] {
+                for(auto i = start; i < std::min(n, start + grain); i++)
+                    work(i);
+            });
+        }
+    });
+    auto stolen = time([&] { par_for(n, 1, work); });
+    os << "imbalanced loop on " << threads << " threads: static " << static_split
+       << "ms, work stealing " << stolen << "ms" << std::endl;
+}
+
+void bench_par_for(std::ostream& os, std::size_t iters)
+{
+    bench_dispatch_latency(os, iters);
+    bench_imbalanced(os);
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace driver
+} // namespace migraphx
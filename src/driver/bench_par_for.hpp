@@ -0,0 +1,18 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_BENCH_PAR_FOR_HPP
+#define MIGRAPHX_GUARD_RTGLIB_BENCH_PAR_FOR_HPP
+
+#include <migraphx/config.hpp>
+#include <cstddef>
+#include <ostream>
+
+namespace migraphx {
+namespace driver {
+inline namespace MIGRAPHX_INLINE_NS {
+
+void bench_par_for(std::ostream& os, std::size_t iters);
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace driver
+} // namespace migraphx
+
+#endif
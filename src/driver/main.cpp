@@ -3,6 +3,8 @@
 #include "command.hpp"
 #include "precision.hpp"
 #include "perf.hpp"
+#include "bench_compile_cache.hpp"
+#include "bench_par_for.hpp"
 #include "models.hpp"
 #include "marker_roctx.hpp"
 
@@ -10,6 +12,7 @@
 #include <migraphx/onnx.hpp>
 #include <migraphx/stringutils.hpp>
 #include <migraphx/load_save.hpp>
+#include <migraphx/marker_trace.hpp>
 #include <migraphx/json.hpp>
 #include <migraphx/version.h>
 
@@ -312,6 +315,7 @@ struct compiler
            ap.help("Disable fast math optimization"),
            ap.set_value(false));
         ap(quantize, {"--fp16"}, ap.help("Quantize for fp16"), ap.set_value(precision::fp16));
+        ap(quantize, {"--bf16"}, ap.help("Quantize for bf16"), ap.set_value(precision::bf16));
         ap(quantize, {"--int8"}, ap.help("Quantize for int8"), ap.set_value(precision::int8));
     }
 
@@ -328,6 +332,10 @@ struct compiler
         {
             quantize_fp16(p);
         }
+        else if(quantize == precision::bf16)
+        {
+            quantize_bf16(p);
+        }
         else if(quantize == precision::int8)
         {
             quantize_int8(p, t, {params(p)});
@@ -397,6 +405,7 @@ struct verify : command<verify>
            ap.set_value(true));
         ap(reduce, {"-r", "--reduce"}, ap.help("Reduce program and verify"), ap.set_value(true));
         ap(quantize, {"--fp16"}, ap.help("Quantize for fp16"), ap.set_value(precision::fp16));
+        ap(quantize, {"--bf16"}, ap.help("Quantize for bf16"), ap.set_value(precision::bf16));
     }
 
     void run()
@@ -485,6 +494,66 @@ struct perf : command<perf>
     }
 };
 
+struct memory : command<memory>
+{
+    compiler c;
+    unsigned n = 10;
+    // The report is written to the loader's --output, as json with --json
+    void parse(argument_parser& ap)
+    {
+        c.parse(ap);
+        ap(n, {"--top", "-n"}, ap.help("Number of the largest tensors live at the peak to show"));
+    }
+
+    static void print(std::ostream& os, const value& report)
+    {
+        for(const auto& mod : report.at("modules"))
+        {
+            os << "Module: " << mod.at("name").to<std::string>() << std::endl;
+            os << "Scratch: " << mod.at("scratch_bytes").to<std::size_t>() << " bytes" << std::endl;
+            os << "Peak live: " << mod.at("peak_bytes").to<std::size_t>() << " bytes" << std::endl;
+            os << "Literals: " << mod.at("literals").to<std::size_t>() << ", "
+               << mod.at("literal_bytes").to<std::size_t>() << " bytes" << std::endl;
+            os << "Parameters: " << mod.at("parameter_bytes").to<std::size_t>() << " bytes"
+               << std::endl;
+            os << "Live at peak:" << std::endl;
+            for(const auto& tensor : mod.at("live_at_peak"))
+            {
+                os << "    " << tensor.at("instruction").to<std::string>() << " = "
+                   << tensor.at("operator").to<std::string>() << " -> "
+                   << tensor.at("shape").to<std::string>() << ": "
+                   << tensor.at("bytes").to<std::size_t>() << " bytes";
+                if(tensor.contains("offset"))
+                    os << ", offset " << tensor.at("offset").to<std::size_t>();
+                os << std::endl;
+            }
+            os << std::endl;
+        }
+        os << "Total scratch: " << report.at("scratch_bytes").to<std::size_t>() << " bytes"
+           << std::endl;
+        os << "Total literals: " << report.at("literal_bytes").to<std::size_t>() << " bytes"
+           << std::endl;
+    }
+
+    void run()
+    {
+        std::cout << "Compiling ... " << std::endl;
+        auto p      = c.compile();
+        auto report = p.memory_report(n);
+        auto* os    = &std::cout;
+        std::ofstream fs;
+        if(not c.l.output.empty())
+        {
+            fs.open(c.l.output);
+            os = &fs;
+        }
+        if(c.l.output_type == "json")
+            *os << to_pretty_json_string(report) << std::endl;
+        else
+            print(*os, report);
+    }
+};
+
 struct roctx : command<roctx>
 {
     compiler c;
@@ -502,6 +571,52 @@ struct roctx : command<roctx>
     }
 };
 
+struct trace : command<trace>
+{
+    compiler c;
+    // The chrome trace is written to the loader's --output
+    void parse(argument_parser& ap) { c.parse(ap); }
+
+    void run()
+    {
+        std::cout << "Compiling ... " << std::endl;
+        auto p = c.compile();
+        std::cout << "Allocating params ... " << std::endl;
+        auto m      = c.params(p);
+        auto output = c.l.output.empty() ? std::string{"trace.json"} : c.l.output;
+        std::cout << "Writing trace to " << output << " ... " << std::endl;
+        std::ofstream fs(output);
+        if(not fs)
+            MIGRAPHX_THROW("Failed to open file: " + output);
+        p.mark(m, create_marker_trace(fs));
+    }
+};
+
+struct par_for_cmd : command<par_for_cmd>
+{
+    unsigned n = 200;
+    void parse(argument_parser& ap)
+    {
+        ap(n, {"--iterations", "-n"}, ap.help("Number of iterations to time the dispatch"));
+    }
+
+    void run() const { bench_par_for(std::cout, n); }
+};
+
+struct compile_cache : command<compile_cache>
+{
+    compiler c;
+    void parse(argument_parser& ap) { c.parse(ap); }
+
+    void run()
+    {
+        compile_options options;
+        options.offload_copy = c.offload_copy;
+        options.fast_math    = c.fast_math;
+        bench_compile_cache(std::cout, [&] { return c.l.load(); }, c.ct.get_target(), options);
+    }
+};
+
 struct op : command<op>
 {
     bool show_ops = false;
@@ -9,6 +9,7 @@ enum class precision
 {
     fp32,
     fp16,
+    bf16,
     int8
 };
 
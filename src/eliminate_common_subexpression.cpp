@@ -5,45 +5,91 @@
 #include <migraphx/ranges.hpp>
 #include <migraphx/functional.hpp>
 
+#include <string_view>
 #include <unordered_set>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+template <class T>
+void hash_combine(std::size_t& seed, const T& x)
+{
+    seed ^= std::hash<T>{}(x) + 0x9e3779b9 + (seed << 6u) + (seed >> 2u);
+}
+
+static std::size_t hash_value(const value& v)
+{
+    std::size_t seed = 0;
+    hash_combine(seed, v.get_key());
+    hash_combine(seed, static_cast<int>(v.get_type()));
+    switch(v.get_type())
+    {
+    case value::int64_type: hash_combine(seed, v.get_int64()); break;
+    case value::uint64_type: hash_combine(seed, v.get_uint64()); break;
+    case value::float_type: hash_combine(seed, v.get_float()); break;
+    case value::string_type: hash_combine(seed, v.get_string()); break;
+    case value::bool_type: hash_combine(seed, v.get_bool()); break;
+    case value::binary_type: {
+        const auto& b = v.get_binary();
+        hash_combine(seed,
+                     std::string_view{reinterpret_cast<const char*>(b.data()), b.size()});
+        break;
+    }
+    case value::array_type:
+    case value::object_type:
+        for(const auto& x : v)
+            hash_combine(seed, hash_value(x));
+        break;
+    case value::null_type: break;
+    }
+    return seed;
+}
+
+// Hash the parts of an instruction that are compared by operator==, so that equal instructions
+// land in the same bucket. The inputs are hashed by identity, which is enough since they have
+// already been replaced by their first equal instruction.
+struct instruction_hash
+{
+    std::size_t operator()(instruction_ref ins) const
+    {
+        std::size_t seed = 0;
+        hash_combine(seed, ins->name());
+        hash_combine(seed, hash_value(ins->get_operator().to_value()));
+        for(auto input : ins->inputs())
+            hash_combine(seed, input);
+        for(const auto* mod : ins->module_inputs())
+            hash_combine(seed, mod);
+        if(ins->name() == "@literal")
+        {
+            const auto& lit = ins->get_literal();
+            hash_combine(seed, std::string_view{lit.data(), lit.get_shape().bytes()});
+        }
+        return seed;
+    }
+};
+
+struct instruction_equal
+{
+    bool operator()(instruction_ref x, instruction_ref y) const { return *x == *y; }
+};
+
 template <class Range>
 void cse_range(module& p, Range&& r)
 {
-    std::unordered_multimap<std::string, instruction_ref> instructions;
-    std::unordered_set<instruction_ref> processed_ins;
+    std::unordered_set<instruction_ref, instruction_hash, instruction_equal> instructions;
     for(auto ins : r)
     {
         // Skip dead instructions
         if(ins->outputs().empty())
             continue;
 
-        // Find instruction with the same name
-        auto found_instructions = range(instructions.equal_range(ins->name()));
-        for(const auto& pp : found_instructions)
-        {
-            auto eq = pp.second;
-            if(contains(processed_ins, eq))
-                continue;
-            if(*eq != *ins)
-                continue;
-            p.replace_instruction(ins, eq);
-            processed_ins.emplace(ins);
-            std::vector<instruction_ref> outputs;
-            std::copy_if(eq->outputs().begin(),
-                         eq->outputs().end(),
-                         std::back_inserter(outputs),
-                         [&](auto x) { return p.has_instruction(x); });
-
-            std::sort(outputs.begin(), outputs.end(), [&](auto x, auto y) {
-                return std::distance(eq, x) < std::distance(eq, y);
-            });
-            cse_range(p, outputs);
-        }
-        instructions.emplace(ins->name(), ins);
+        // The instructions are visited in order, so the inputs of the outputs of a replaced
+        // instruction are updated before the outputs are visited
+        auto eq = instructions.find(ins);
+        if(eq != instructions.end())
+            p.replace_instruction(ins, *eq);
+        else
+            instructions.insert(ins);
     }
 }
 
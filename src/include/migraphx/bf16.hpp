@@ -0,0 +1,171 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_BF16_HPP
+#define MIGRAPHX_GUARD_RTGLIB_BF16_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/half.hpp>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/**
+ * The bfloat16 type, which is the upper 16 bits of a float. It only stores the value, and is
+ * converted to float for arithmetic.
+ */
+struct bf16
+{
+    std::uint16_t data = 0;
+
+    constexpr bf16() = default;
+
+    explicit bf16(float x) : data(from_float(x)) {}
+
+    template <class T,
+              class = std::enable_if_t<std::is_convertible<T, float>{} and
+                                       not std::is_same<std::decay_t<T>, bf16>{}>>
+    explicit bf16(T x) : bf16(static_cast<float>(x))
+    {
+    }
+
+    bf16& operator=(float x)
+    {
+        data = from_float(x);
+        return *this;
+    }
+
+    operator float() const { return to_float(data); }
+
+    static constexpr bf16 from_bits(std::uint16_t x)
+    {
+        bf16 result{};
+        result.data = x;
+        return result;
+    }
+
+    // Round to the nearest even value
+    static std::uint16_t from_float(float x)
+    {
+        std::uint32_t bits = 0;
+        std::memcpy(&bits, &x, sizeof(bits));
+        // Keep nan quiet, since rounding could turn it into infinity
+        if(std::isnan(x))
+            return (bits >> 16u) | 0x40u;
+        bits += 0x7fffu + ((bits >> 16u) & 1u);
+        return bits >> 16u;
+    }
+
+    static float to_float(std::uint16_t x)
+    {
+        std::uint32_t bits = std::uint32_t{x} << 16u;
+        float result       = 0;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    template <class T>
+    bf16& operator+=(T x)
+    {
+        return *this = float(*this) + x;
+    }
+
+    template <class T>
+    bf16& operator-=(T x)
+    {
+        return *this = float(*this) - x;
+    }
+
+    template <class T>
+    bf16& operator*=(T x)
+    {
+        return *this = float(*this) * x;
+    }
+
+    template <class T>
+    bf16& operator/=(T x)
+    {
+        return *this = float(*this) / x;
+    }
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+namespace std {
+
+template <>
+class numeric_limits<migraphx::bf16>
+{
+    using bf16 = migraphx::bf16;
+
+    public:
+    static constexpr bool is_specialized    = true;
+    static constexpr bool is_signed         = true;
+    static constexpr bool is_integer        = false;
+    static constexpr bool is_exact          = false;
+    static constexpr bool has_infinity      = true;
+    static constexpr bool has_quiet_NaN     = true;
+    static constexpr bool has_signaling_NaN = true;
+    static constexpr float_denorm_style has_denorm = denorm_present;
+    static constexpr bool has_denorm_loss          = false;
+    static constexpr float_round_style round_style = round_to_nearest;
+    static constexpr bool is_iec559                = false;
+    static constexpr bool is_bounded               = true;
+    static constexpr bool is_modulo                = false;
+    static constexpr int digits                    = 8;
+    static constexpr int digits10                  = 2;
+    static constexpr int max_digits10              = 4;
+    static constexpr int radix                     = 2;
+    static constexpr int min_exponent              = numeric_limits<float>::min_exponent;
+    static constexpr int min_exponent10            = numeric_limits<float>::min_exponent10;
+    static constexpr int max_exponent              = numeric_limits<float>::max_exponent;
+    static constexpr int max_exponent10            = numeric_limits<float>::max_exponent10;
+    static constexpr bool traps                    = false;
+    static constexpr bool tinyness_before          = false;
+
+    static constexpr bf16 min() noexcept { return bf16::from_bits(0x0080); }
+    static constexpr bf16 lowest() noexcept { return bf16::from_bits(0xff7f); }
+    static constexpr bf16 max() noexcept { return bf16::from_bits(0x7f7f); }
+    static constexpr bf16 epsilon() noexcept { return bf16::from_bits(0x3c00); }
+    static constexpr bf16 round_error() noexcept { return bf16::from_bits(0x3f00); }
+    static constexpr bf16 infinity() noexcept { return bf16::from_bits(0x7f80); }
+    static constexpr bf16 quiet_NaN() noexcept { return bf16::from_bits(0x7fc0); }
+    static constexpr bf16 signaling_NaN() noexcept { return bf16::from_bits(0x7fa0); }
+    static constexpr bf16 denorm_min() noexcept { return bf16::from_bits(0x0001); }
+};
+
+template <class T>
+struct common_type<migraphx::bf16, T> : std::common_type<float, T>
+{
+};
+
+template <class T>
+struct common_type<T, migraphx::bf16> : std::common_type<float, T>
+{
+};
+
+template <>
+struct common_type<migraphx::bf16, migraphx::bf16>
+{
+    using type = migraphx::bf16;
+};
+
+// Neither type can represent the other, so mixing them computes in float
+template <>
+struct common_type<migraphx::bf16, migraphx::half>
+{
+    using type = float;
+};
+
+template <>
+struct common_type<migraphx::half, migraphx::bf16>
+{
+    using type = float;
+};
+
+} // namespace std
+
+#endif
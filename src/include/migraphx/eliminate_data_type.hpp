@@ -13,12 +13,14 @@ struct module;
 
 /**
  * Remove data types. This will instert convert operators so the data type
- * is not used by any operator.
+ * is not used by any operator, except the operators in `supported_ops` which
+ * already support the data types.
  */
 struct eliminate_data_type
 {
     std::set<shape::type_t> types;
     shape::type_t target_type;
+    std::set<std::string> supported_ops = {};
     std::string name() const { return "eliminate_data_type"; }
     void apply(module& m) const;
 };
@@ -23,7 +23,7 @@ void gemm(tensor_view<T> cmat, tensor_view<T> amat, tensor_view<T> bmat, F alpha
     auto cs = cmat.get_shape();
 
     par_for(cs.elements(), [&](auto i) {
-        auto c_idx = cs.multi(i);
+        multi_index c_idx{cs, i};
         auto a_idx = c_idx;
         auto b_idx = c_idx;
         double s   = 0.0;
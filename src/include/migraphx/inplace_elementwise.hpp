@@ -0,0 +1,28 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_INPLACE_ELEMENTWISE_HPP
+#define MIGRAPHX_GUARD_RTGLIB_INPLACE_ELEMENTWISE_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/allocation_model.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct module;
+
+/**
+ * Write the output of an operator into one of its inputs, instead of its allocation, when the
+ * input has the same shape and is not used afterwards. Only operators with the "inplace"
+ * attribute are changed, which declares that each output element only depends on the input
+ * elements at the same index.
+ */
+struct inplace_elementwise
+{
+    allocation_model model;
+    std::string name() const { return "inplace_elementwise"; }
+    void apply(module& m) const;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -104,6 +104,10 @@ struct instruction
 
     static instruction_ref get_output_alias(instruction_ref ins, bool shallow = false);
 
+    /// Check that the buffer of x is only used along the chain of aliases that ends at ins, so
+    /// every other use happens before ins reads it
+    static bool is_only_used_by(instruction_ref x, instruction_ref ins);
+
     void set_normalized(bool value = true);
     bool is_normalized() const;
 
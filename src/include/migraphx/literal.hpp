@@ -16,7 +16,8 @@ inline namespace MIGRAPHX_INLINE_NS {
 
 /**
  * @brief Represents a raw literal
- * @details This stores the literal has a raw buffer that is owned by this class
+ * @details This stores the literal has a raw buffer that is owned by this class, or shared with
+ * the buffer it was constructed from
  */
 struct literal : raw_data<literal>
 {
@@ -58,6 +59,9 @@ struct literal : raw_data<literal>
         std::copy(x, x + s.bytes(), buffer.get());
     }
 
+    /// Refers to the data in `b` without copying it
+    literal(const shape& s, std::shared_ptr<char> b) : buffer(std::move(b)), m_shape(s) {}
+
     /// Whether data is available
     bool empty() const { return this->buffer == nullptr; }
 
@@ -68,12 +72,8 @@ struct literal : raw_data<literal>
 
     std::vector<literal> get_sub_objects() const { return {}; }
 
-    /// Convert the data to an argument
-    argument get_argument() const
-    {
-        auto b = make_shared_array<char>(buffer.get(), buffer.get() + m_shape.bytes());
-        return {m_shape, [b]() { return b.get(); }};
-    }
+    /// Convert the data to an argument, which shares the buffer so it must not be written to
+    argument get_argument() const { return {m_shape, buffer}; }
 
     private:
     std::shared_ptr<char> buffer;
@@ -0,0 +1,39 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_MAPPED_FILE_HPP
+#define MIGRAPHX_GUARD_RTGLIB_MAPPED_FILE_HPP
+
+#include <migraphx/config.hpp>
+#include <memory>
+#include <string>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/**
+ * @brief A file mapped into memory
+ * @details The pages are only read from disk when they are accessed. Writes to the mapping are
+ * private to this process and are never written back to the file. Copies share the same mapping,
+ * which stays alive as long as a copy or a pointer returned by `share` is alive.
+ */
+struct mapped_file
+{
+    mapped_file() = default;
+    explicit mapped_file(const std::string& filename);
+
+    /// Whether a file is mapped
+    bool empty() const;
+
+    const char* data() const;
+    std::size_t size() const;
+
+    /// A pointer `offset` bytes into the file that keeps the mapping alive
+    std::shared_ptr<char> share(std::size_t offset = 0) const;
+
+    private:
+    std::shared_ptr<char> buffer = nullptr;
+    std::size_t nbytes           = 0;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
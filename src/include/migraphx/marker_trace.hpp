@@ -0,0 +1,21 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_MARKER_TRACE_HPP
+#define MIGRAPHX_GUARD_RTGLIB_MARKER_TRACE_HPP
+
+#include <migraphx/marker.hpp>
+#include <migraphx/config.hpp>
+#include <ostream>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/**
+ * Create a marker that records when each instruction starts and stops, along with its thread,
+ * operator, shapes and bytes. When the program stops, the events are written to the stream in
+ * the Chrome trace event format, which can be viewed with chrome://tracing or Perfetto.
+ */
+marker create_marker_trace(std::ostream& os);
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef MIGRAPHX_GUARD_MATCH_ATTENTION_HPP
+#define MIGRAPHX_GUARD_MATCH_ATTENTION_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/matcher.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace match {
+
+namespace detail {
+template <class F>
+struct attention_matcher
+{
+    F f;
+    // The parts of the pattern are type erased, since nesting the alternatives makes the matcher
+    // too large to compile
+    any_matcher scores() const
+    {
+        return f("dot")(used_once(), arg(0)(any().bind("q")), arg(1)(any().bind("k")))
+            .bind("scores");
+    }
+
+    any_matcher scaled() const
+    {
+        auto scale = skip_broadcasts(is_constant().bind("scale"));
+        return any_of(f("mul")(used_once(), arg(0)(scores()), arg(1)(scale)),
+                      f("div")(used_once(), arg(0)(scores()), arg(1)(scale)))
+            .bind("scaled");
+    }
+
+    any_matcher masked() const
+    {
+        return f("add")(used_once(), any_arg(0, 1)(any_of(scaled(), scores()))).bind("masked");
+    }
+
+    auto matcher() const
+    {
+        auto probabilities =
+            f("softmax")(used_once(), arg(0)(any_of(masked(), scaled(), scores())));
+        return f("dot")(arg(0)(probabilities.bind("softmax")), arg(1)(any().bind("v")));
+    }
+};
+} // namespace detail
+
+template <class F>
+auto attention(F f)
+{
+    return detail::attention_matcher<F>{f}.matcher();
+}
+
+/// Match `dot(softmax(dot(q, k) * scale + mask), v)`, where the scale and the mask are optional.
+/// The scale is bound as "scale" and the add of the mask as "masked".
+inline auto attention()
+{
+    return attention([](auto x) { return name(x); });
+}
+
+} // namespace match
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+#endif // MIGRAPHX_GUARD_MATCH_ATTENTION_HPP
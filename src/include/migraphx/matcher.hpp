@@ -8,7 +8,10 @@
 #include <migraphx/optional.hpp>
 #include <migraphx/iterator_for.hpp>
 #include <migraphx/type_name.hpp>
+#include <migraphx/rank.hpp>
 #include <migraphx/config.hpp>
+#include <array>
+#include <functional>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -96,22 +99,62 @@ function_matcher<F> make_function_matcher(F f)
     return {f};
 }
 
+template <class M>
+auto get_root_names_impl(rank<1>, const M& m) -> decltype(m.root_names())
+{
+    return m.root_names();
+}
+
+template <class M>
+std::unordered_set<std::string> get_root_names_impl(rank<0>, const M&)
+{
+    return {};
+}
+
+/// Get the names of the operators the matcher can match at the root, an empty set means it can
+/// match any operator
+template <class M>
+std::unordered_set<std::string> get_root_names(const M& m)
+{
+    return get_root_names_impl(rank<1>{}, m);
+}
+
+/// Attach the names of the operators that can match at the root to a matcher
+template <class M>
+struct root_names_matcher
+{
+    M m;
+    std::unordered_set<std::string> names;
+
+    auto match(matcher_context& ctx, instruction_ref ins) const { return m.match(ctx, ins); }
+
+    const std::unordered_set<std::string>& root_names() const { return names; }
+};
+
+template <class M>
+root_names_matcher<M> make_root_names_matcher(M m, std::unordered_set<std::string> names)
+{
+    return {m, std::move(names)};
+}
+
 /// Converts a matcher to bind the instruction to name
 template <class M>
 auto bind_match(M m, std::string name)
 {
-    return make_function_matcher(
-        [=, name = std::move(name)](matcher_context& ctx,
-                                    instruction_ref ins) -> optional<instruction_ref> {
-            auto result = m.match(ctx, ins);
-            if(result)
-            {
-                if(not ctx.has_instruction(ins))
-                    return nullopt;
-                ctx.instructions[name] = ins;
-            }
-            return result;
-        });
+    return make_root_names_matcher(
+        make_function_matcher(
+            [=, name = std::move(name)](matcher_context& ctx,
+                                        instruction_ref ins) -> optional<instruction_ref> {
+                auto result = m.match(ctx, ins);
+                if(result)
+                {
+                    if(not ctx.has_instruction(ins))
+                        return nullopt;
+                    ctx.instructions[name] = ins;
+                }
+                return result;
+            }),
+        get_root_names(m));
 }
 
 /// Convert a matcher to a bindable matcher
@@ -123,6 +166,8 @@ struct bindable_matcher
     auto bind(std::string name) const { return bind_match(m, std::move(name)); }
 
     auto match(matcher_context& ctx, instruction_ref ins) const { return m.match(ctx, ins); }
+
+    auto root_names() const { return get_root_names(m); }
 };
 
 /// Create a bindable matcher
@@ -167,8 +212,8 @@ struct basic_matcher
     {
         // Copy m because we cant capture `this` by value
         auto mm = m;
-        return make_bf_matcher([=](matcher_context& ctx,
-                                   instruction_ref ins) -> optional<instruction_ref> {
+        auto f  = make_function_matcher([=](matcher_context& ctx,
+                                           instruction_ref ins) -> optional<instruction_ref> {
             auto result = mm.match(ctx, ins);
             if(result)
             {
@@ -179,11 +224,14 @@ struct basic_matcher
             }
             return nullopt;
         });
+        return make_bindable_matcher(make_root_names_matcher(f, get_root_names(m)));
     }
 
     auto bind(std::string name) const { return bind_match(m, std::move(name)); }
 
     auto match(matcher_context& ctx, instruction_ref ins) const { return m.match(ctx, ins); }
+
+    auto root_names() const { return get_root_names(m); }
 };
 
 /// Create a basic matcher from a matcher
@@ -213,9 +261,16 @@ using any_matcher_base = basic_matcher<
 struct any_matcher : any_matcher_base
 {
     template <class M>
-    any_matcher(M mm) : any_matcher_base({[=](auto& ctx, auto ins) { return mm.match(ctx, ins); }})
+    any_matcher(M mm)
+        : any_matcher_base({[=](auto& ctx, auto ins) { return mm.match(ctx, ins); }}),
+          names(get_root_names(mm))
     {
     }
+
+    const std::unordered_set<std::string>& root_names() const { return names; }
+
+    private:
+    std::unordered_set<std::string> names;
 };
 
 /// This macro takes care of the boilerplate for defining a matcher
@@ -279,6 +334,22 @@ match::matcher_result find_match(module& modl, M&& m)
 
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_MATCHES)
 
+/// Apply the finder when its matcher matches the instruction
+template <class Finder, class M>
+bool apply_match(module& mod, instruction_ref ins, Finder& f, const M& m, bool trace)
+{
+    auto r = match_instruction(mod, ins, m);
+    if(r.result == mod.end())
+        return false;
+    if(trace)
+    {
+        std::cout << "Matched by " << get_type_name(f) << std::endl;
+        mod.debug_print(ins);
+    }
+    f.apply(mod, r);
+    return true;
+}
+
 /// Find matches for an instruction in the module
 template <class... Ms>
 void find_matches(module& mod, instruction_ref ins, Ms&&... ms)
@@ -292,27 +363,61 @@ void find_matches(module& mod, instruction_ref ins, Ms&&... ms)
         [&](auto&& m) {
             if(match)
                 return;
-            auto r = match_instruction(mod, ins, m.matcher());
-            if(r.result == mod.end())
-                return;
-            if(trace)
-            {
-                std::cout << "Matched by " << get_type_name(m) << std::endl;
-                mod.debug_print(ins);
-            }
-            m.apply(mod, r);
-            match = true;
+            match = apply_match(mod, ins, m, m.matcher(), trace);
         },
         ms...);
 }
 
-/// Find matches in a module
+/// Find matches in a module. The finders are indexed by the names of the operators their
+/// matchers can match at the root, so each instruction only tries the finders that can match it,
+/// in the order they are given.
 template <class... Ms>
 void find_matches(module& mod, Ms&&... ms)
 {
+    bool trace = enabled(MIGRAPHX_TRACE_MATCHES{});
+    std::vector<std::function<bool(instruction_ref)>> finders;
+    std::vector<std::unordered_set<std::string>> names;
+    each_args(
+        [&](auto&& f) {
+            auto m = f.matcher();
+            names.push_back(get_root_names(m));
+            finders.push_back([&mod, &f, m, trace](instruction_ref ins) {
+                return apply_match(mod, ins, f, m, trace);
+            });
+        },
+        ms...);
+
+    std::unordered_map<std::string, std::vector<std::size_t>> dispatch;
+    for(const auto& n : names)
+    {
+        for(const auto& name : n)
+            dispatch[name];
+    }
+    for(auto&& p : dispatch)
+    {
+        for(std::size_t i = 0; i < names.size(); i++)
+        {
+            if(names[i].empty() or contains(names[i], p.first))
+                p.second.push_back(i);
+        }
+    }
+    // The finders that can match any operator
+    std::vector<std::size_t> any_name;
+    for(std::size_t i = 0; i < names.size(); i++)
+    {
+        if(names[i].empty())
+            any_name.push_back(i);
+    }
+
     for(auto ins : iterator_for(mod))
     {
-        find_matches(mod, ins, ms...);
+        auto it                = dispatch.find(ins->name());
+        const auto& candidates = it == dispatch.end() ? any_name : it->second;
+        for(auto i : candidates)
+        {
+            if(finders[i](ins))
+                break;
+        }
     }
 }
 
@@ -382,16 +487,44 @@ struct match_fold_f
         return p([&](auto... ms) { return match_fold_f::fold_matchers(ctx, ins, ms...); });
     }
 
+    static std::unordered_set<std::string>
+    fold_root_names(const std::vector<std::unordered_set<std::string>>& names)
+    {
+        // Nothing is known about the root when the matchers must not match
+        if(not Matches)
+            return {};
+        // When all of them must match, the names of any of them are enough
+        if(std::is_same<Op, lazy_and>{})
+        {
+            auto it = std::find_if(
+                names.begin(), names.end(), [](const auto& n) { return not n.empty(); });
+            if(it == names.end())
+                return {};
+            return *it;
+        }
+        // When any of them can match, the names are only known when they are known for each one
+        std::unordered_set<std::string> result;
+        for(const auto& n : names)
+        {
+            if(n.empty())
+                return {};
+            result.insert(n.begin(), n.end());
+        }
+        return result;
+    }
+
     template <class... Ts>
     auto operator()(Ts... ms) const
     {
-        return make_bf_matcher(
+        auto f = make_function_matcher(
             [=](matcher_context& ctx, instruction_ref ins) -> optional<instruction_ref> {
                 bool matches = match_fold_f::fold_matchers(ctx, ins, ms...);
                 if(matches == Matches)
                     return {ins};
                 return nullopt;
             });
+        return make_bindable_matcher(
+            make_root_names_matcher(f, fold_root_names({get_root_names(ms)...})));
     }
 
     template <class Selector>
@@ -535,8 +668,8 @@ auto skip_output(Ms... ms)
 
 inline auto name(std::string s)
 {
-    return make_basic_pred_matcher(
-        [=, s = std::move(s)](instruction_ref ins) { return ins->name() == s; });
+    auto p = [=](instruction_ref ins) { return ins->name() == s; };
+    return make_basic_matcher(make_root_names_matcher(predicate_matcher<decltype(p)>{p}, {s}));
 }
 
 inline auto name_contains(const std::string& name)
@@ -547,9 +680,8 @@ inline auto name_contains(const std::string& name)
 
 inline auto name(std::unordered_set<std::string> names)
 {
-    return make_basic_pred_matcher([=, names = std::move(names)](instruction_ref ins) {
-        return names.count(ins->name()) > 0;
-    });
+    auto p = [=](instruction_ref ins) { return names.count(ins->name()) > 0; };
+    return make_basic_matcher(make_root_names_matcher(predicate_matcher<decltype(p)>{p}, names));
 }
 
 template <class... Ts>
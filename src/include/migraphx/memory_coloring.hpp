@@ -10,12 +10,16 @@ inline namespace MIGRAPHX_INLINE_NS {
 struct module;
 
 /**
- * Remove memory allocations. It uses graph coloring to find memory allocations that can be reused.
+ * Remove memory allocations. It uses graph coloring to find memory allocations that can be reused,
+ * or packs the allocations by their sizes and live ranges when packing is set.
  */
 struct memory_coloring
 {
     std::string allocation_op{};
-    bool verify = false;
+    bool verify  = false;
+    bool packing = false;
+    // The alignment in bytes of the offsets chosen by packing
+    std::size_t alignment = 32;
     std::string name() const { return "memory coloring"; }
     void apply(module& p) const;
 };
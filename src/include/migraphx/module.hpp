@@ -49,6 +49,12 @@ struct module
     bool bypass() const;
     void set_bypass(bool b = true);
 
+    /// A counter that changes every time the module is modified
+    std::size_t version() const;
+    /// Change the version, for modifications made to the instructions directly, such as
+    /// `instruction::replace_argument`
+    void update_version();
+
     template <class... Ts, MIGRAPHX_REQUIRES(std::is_same<Ts, instruction_ref>{}...)>
     instruction_ref add_instruction(operation op, Ts... args)
     {
@@ -44,7 +44,7 @@ struct argmax
     }
 
     template <class T>
-    int64_t calc_argmax(T& input, std::vector<std::size_t>& indices, size_t item_num) const
+    int64_t calc_argmax(T& input, multi_index& indices, size_t item_num) const
     {
         auto max_val      = input(indices.begin(), indices.end());
         int64_t max_index = 0;
@@ -70,8 +70,8 @@ struct argmax
         result.visit([&](auto output) {
             args[0].visit([&](auto input) {
                 par_for(output_shape.elements(), [&](auto i) {
-                    auto data_idx = output_shape.multi(i);
-                    output[i]     = this->calc_argmax(input, data_idx, batch_item_num);
+                    multi_index data_idx{output_shape, i};
+                    output[i] = this->calc_argmax(input, data_idx, batch_item_num);
                 });
             });
         });
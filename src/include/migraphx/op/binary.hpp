@@ -4,6 +4,7 @@
 #include <migraphx/op/name.hpp>
 #include <migraphx/check_shapes.hpp>
 #include <migraphx/shape_for_each.hpp>
+#include <migraphx/par_transform.hpp>
 #include <migraphx/argument.hpp>
 #include <migraphx/stringutils.hpp>
 #include <migraphx/value.hpp>
@@ -64,11 +65,7 @@ struct binary : op_name<Derived>
     {
         argument result{output_shape};
         visit_all(result, args[0], args[1])([&](auto output, auto input1, auto input2) {
-            std::transform(input1.begin(),
-                           input1.end(),
-                           input2.begin(),
-                           output.begin(),
-                           static_cast<const Derived&>(*this).apply());
+            par_transform(output, static_cast<const Derived&>(*this).apply(), input1, input2);
         });
         return result;
     }
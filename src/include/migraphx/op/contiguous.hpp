@@ -6,7 +6,7 @@
 #include <migraphx/stringutils.hpp>
 #include <migraphx/streamutils.hpp>
 #include <migraphx/literal.hpp>
-#include <migraphx/shape_for_each.hpp>
+#include <migraphx/par_transform.hpp>
 #include <migraphx/config.hpp>
 #include <cmath>
 #include <utility>
@@ -37,11 +37,8 @@ struct contiguous
     {
         assert(output_shape.standard());
         argument result{output_shape};
-        visit_all(result, args[0])([&](auto output, auto input) {
-            shape_for_each(output.get_shape(), [&](const auto& idx) {
-                output(idx.begin(), idx.end()) = input(idx.begin(), idx.end());
-            });
-        });
+        visit_all(result, args[0])(
+            [&](auto output, auto input) { par_transform(output, this->apply(), input); });
         return result;
     }
 
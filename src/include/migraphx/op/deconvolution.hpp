@@ -97,47 +97,41 @@ struct deconvolution
             shape win_shape{output_shape.type(), win_size};
 
             par_dfor(in_n, wei_c)([&](int o, int k) {
-                shape_for_each(win_shape, [&](auto idx_win) {
-                    const int w = idx_win[0];
+                shape_for_each(win_shape, [&](const auto& idx_win) {
+                    const std::size_t w = idx_win[0];
 
                     auto input_dims_start = idx_win.begin() + 1;
                     auto wei_dims_start   = idx_win.begin() + kdims + 1;
 
-                    std::vector<std::ptrdiff_t> win_start;
-                    for(std::size_t n = 0; n < kdims; ++n)
-                    {
-                        win_start.push_back(std::ptrdiff_t(*(input_dims_start + n) * stride[n]) -
-                                            std::ptrdiff_t(padding[n]));
-                    }
-
-                    const int group_id = w / (wei_n / group);
-                    const int in_ch    = group_id * wei_c + k;
+                    const std::size_t group_id = w / (wei_n / group);
+                    const std::size_t in_ch    = group_id * wei_c + k;
 
-                    std::vector<std::ptrdiff_t> idx_out{o, in_ch};
-
-                    for(size_t n = 0; n < kdims; n++)
+                    multi_index idx_out(kdims + 2);
+                    idx_out[0] = o;
+                    idx_out[1] = in_ch;
+                    for(std::size_t n = 0; n < kdims; ++n)
                     {
-                        idx_out.push_back(win_start[n] + *(wei_dims_start + n) * dilation[n]);
+                        auto i = std::ptrdiff_t(*(input_dims_start + n) * stride[n]) -
+                                 std::ptrdiff_t(padding[n]) +
+                                 std::ptrdiff_t(*(wei_dims_start + n) * dilation[n]);
+                        if(i < 0 or i >= std::ptrdiff_t(out_lens[n + 2]))
+                            return;
+                        idx_out[n + 2] = i;
                     }
 
-                    std::vector<std::ptrdiff_t> idx_wei{w, k};
-                    std::copy(wei_dims_start, idx_win.end(), std::back_inserter(idx_wei));
+                    multi_index idx_wei(kdims + 2);
+                    idx_wei[0] = w;
+                    idx_wei[1] = k;
+                    std::copy(wei_dims_start, idx_win.end(), idx_wei.begin() + 2);
 
-                    std::vector<std::ptrdiff_t> idx_in{o, w};
-                    std::copy(input_dims_start, wei_dims_start, std::back_inserter(idx_in));
+                    multi_index idx_in(kdims + 2);
+                    idx_in[0] = o;
+                    idx_in[1] = w;
+                    std::copy(input_dims_start, wei_dims_start, idx_in.begin() + 2);
 
-                    if(std::all_of(
-                           idx_out.begin() + 2, idx_out.end(), [&](auto ii) { return ii >= 0; }) and
-                       std::equal(idx_out.begin() + 2,
-                                  idx_out.end(),
-                                  out_lens.begin() + 2,
-                                  out_lens.end(),
-                                  std::less<std::ptrdiff_t>{}))
-                    {
-                        output(idx_out.begin(), idx_out.end()) +=
-                            input(idx_in.begin(), idx_in.end()) *
-                            weights(idx_wei.begin(), idx_wei.end());
-                    }
+                    output(idx_out.begin(), idx_out.end()) +=
+                        input(idx_in.begin(), idx_in.end()) *
+                        weights(idx_wei.begin(), idx_wei.end());
                 });
             });
         });
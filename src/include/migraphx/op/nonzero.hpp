@@ -32,10 +32,10 @@ struct nonzero
         std::vector<std::vector<std::size_t>> vec_idx;
         auto s = args.front().get_shape();
         args.front().visit([&](auto v) {
-            shape_for_each(s, [&](auto idx) {
+            shape_for_each(s, [&](const auto& idx) {
                 if(not float_equal(v[s.index(idx)], 0))
                 {
-                    vec_idx.push_back(idx);
+                    vec_idx.emplace_back(idx.begin(), idx.end());
                 }
             });
         });
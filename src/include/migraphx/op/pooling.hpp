@@ -144,37 +144,39 @@ struct pooling
         auto in_s    = input.get_shape();
         auto in_lens = in_s.lens();
         par_for(output_shape.elements(), [&](auto i) {
-            auto idx_o = output_shape.multi(i);
+            multi_index idx_o{output_shape, i};
             auto n_dim = idx_o.size();
-            std::vector<std::size_t> win_start;
-            std::vector<std::size_t> win_size;
+            multi_index win_start(n_dim);
+            multi_index win_size(n_dim);
+            win_start[0] = idx_o[0];
+            win_start[1] = idx_o[1];
+            win_size[0]  = 1;
+            win_size[1]  = 1;
             for(std::size_t dim = 2; dim < n_dim; ++dim)
             {
                 auto d_2 = dim - 2;
                 int start =
                     static_cast<int>(idx_o[dim] * stride[d_2]) - static_cast<int>(padding[d_2]);
-                int end = std::min(start + lengths[d_2], in_lens[dim]);
-                start   = std::max(start, 0);
-                win_start.push_back(start);
-                win_size.push_back(end - start);
+                int end        = std::min(start + lengths[d_2], in_lens[dim]);
+                start          = std::max(start, 0);
+                win_start[dim] = start;
+                win_size[dim]  = end - start;
             }
 
-            shape win_shape{output_shape.type(), win_size};
-            auto pool_size    = win_shape.elements();
+            auto pool_size = std::accumulate(
+                win_size.begin(), win_size.end(), std::size_t{1}, std::multiplies<>{});
             double output_val = op.template init<Type>();
-            shape_for_each(win_shape, [&](auto idx_w) {
-                auto idx = idx_o;
-                std::transform(idx_w.begin(),
-                               idx_w.end(),
-                               win_start.begin(),
-                               idx.begin() + 2,
-                               [](auto ii, auto jj) { return ii + jj; });
-                if(std::all_of(idx.begin() + 2, idx.end(), [&](auto ii) { return ii >= 0; }) and
-                   idx < in_lens)
-                {
-                    output_val = op(output_val, input[in_s.index(idx)]);
-                }
-            });
+            // Walk the window with an odometer, the window is clipped to the input so every
+            // index is in bounds
+            auto base = in_s.index(win_start);
+            multi_index idx_w(n_dim);
+            for(std::size_t k = 0; k < pool_size; k++)
+            {
+                auto offset =
+                    std::inner_product(idx_w.begin(), idx_w.end(), in_s.strides().begin(), base);
+                output_val = op(output_val, input.data()[offset]);
+                idx_w.increment(win_size);
+            }
             output[i] = Type(op.final(output_val, pool_size));
         });
     }
@@ -95,10 +95,8 @@ struct reduce_op : op_name<Derived>
         return inputs[0].with_lens(lens);
     }
 
-    template <class T>
-    void tune_dims(const std::vector<int64_t>& tuned_axes,
-                   const std::vector<T>& in_lens,
-                   std::vector<T>& out_lens) const
+    template <class In, class Out>
+    void tune_dims(const std::vector<int64_t>& tuned_axes, const In& in_lens, Out& out_lens) const
     {
         for(auto axis : tuned_axes)
         {
@@ -110,14 +108,14 @@ struct reduce_op : op_name<Derived>
     void reduce(tensor_view<T>& input,
                 shape& batch_shape,
                 std::vector<int64_t>& tuned_axes,
-                std::vector<std::size_t>& out_idx,
+                const multi_index& out_idx,
                 tensor_view<T>& output) const
     {
         using accumulator = accumulator_type<T>;
         auto& self        = static_cast<const Derived&>(*this);
         auto data_idx     = out_idx;
         accumulator val   = self.init();
-        shape_for_each(batch_shape, [&](auto b_idx) {
+        shape_for_each(batch_shape, [&](const auto& b_idx) {
             this->tune_dims(tuned_axes, b_idx, data_idx);
             accumulator x = input(data_idx.begin(), data_idx.end());
             val           = self.op()(accumulator{self.input()(x)}, val);
@@ -137,7 +135,7 @@ struct reduce_op : op_name<Derived>
         shape batch_shape{output_shape.type(), batch_lens};
         visit_all(result, args[0])([&](auto output, auto input) {
             par_for(output_shape.elements(), [&](auto i) {
-                auto out_idx = output_shape.multi(i);
+                multi_index out_idx{output_shape, i};
                 this->reduce(input, batch_shape, tuned_axes, out_idx, output);
             });
         });
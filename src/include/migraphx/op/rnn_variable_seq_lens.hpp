@@ -42,7 +42,7 @@ struct rnn_var_sl_shift_output
             using value_type = typename decltype(output)::value_type;
             args[1].visit([&](auto seq_lens) {
                 par_for(output_shape.elements(), [&](auto i) {
-                    auto idx       = output_shape.multi(i);
+                    multi_index idx{output_shape, i};
                     auto batch_id  = idx[2];
                     auto d         = idx[1];
                     auto t         = idx[0];
@@ -81,7 +81,7 @@ struct rnn_var_sl_shift_sequence
             using value_type = typename decltype(output)::value_type;
             args[1].visit([&](auto seq_lens) {
                 par_for(output_shape.elements(), [&](auto i) {
-                    auto idx       = output_shape.multi(i);
+                    multi_index idx{output_shape, i};
                     auto b         = idx[1];
                     auto t         = idx[0];
                     auto sl        = seq_lens[b];
@@ -99,7 +99,7 @@ struct topk
         visit_all(res_val, args.front())([&](auto out_val, auto input) {
             auto* out_ind = res_ind.cast<int64_t>();
             par_for(comp_s.elements(), [&](auto i) {
-                auto idx = comp_s.multi(i);
+                multi_index idx{comp_s, i};
                 std::vector<std::size_t> indices(k);
                 std::iota(indices.begin(), indices.end(), 0);
 
@@ -4,6 +4,7 @@
 #include <migraphx/op/name.hpp>
 #include <migraphx/check_shapes.hpp>
 #include <migraphx/shape_for_each.hpp>
+#include <migraphx/par_transform.hpp>
 #include <migraphx/argument.hpp>
 #include <migraphx/stringutils.hpp>
 #include <migraphx/value.hpp>
@@ -60,10 +61,7 @@ struct unary : op_name<Derived>
         argument result{output_shape};
         result.visit([&](auto output) {
             args[0].visit([&](auto input) {
-                std::transform(input.begin(),
-                               input.end(),
-                               output.begin(),
-                               static_cast<const Derived&>(*this).apply());
+                par_transform(output, static_cast<const Derived&>(*this).apply(), input);
             });
         });
         return result;
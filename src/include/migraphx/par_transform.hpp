@@ -0,0 +1,88 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_PAR_TRANSFORM_HPP
+#define MIGRAPHX_GUARD_RTGLIB_PAR_TRANSFORM_HPP
+
+#include <migraphx/par_for.hpp>
+#include <migraphx/reduce_dims.hpp>
+#include <migraphx/tensor_view.hpp>
+#include <algorithm>
+#include <array>
+#include <type_traits>
+#include <utility>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+namespace detail {
+
+using zero_stride = std::integral_constant<std::size_t, 0>;
+using unit_stride = std::integral_constant<std::size_t, 1>;
+
+template <class F>
+void visit_unit_strides(const std::size_t*, F f)
+{
+    f();
+}
+
+// Pass the strides, which are all 0 or 1, as constants so the loop over a row can be vectorized
+template <class F, class X, class... Xs>
+void visit_unit_strides(const std::size_t* strides, F f, X, Xs... xs)
+{
+    visit_unit_strides(strides + 1,
+                       [&](auto... ss) {
+                           if(*strides == 0)
+                               f(zero_stride{}, ss...);
+                           else
+                               f(unit_stride{}, ss...);
+                       },
+                       xs...);
+}
+
+template <class T, class F, class... Ts, std::size_t... Is>
+void par_transform_impl(std::index_sequence<Is...>,
+                        tensor_view<T> output,
+                        F f,
+                        tensor_view<Ts>... inputs)
+{
+    constexpr std::size_t min_elements = 4096;
+    auto shapes = reduce_dims({output.get_shape(), inputs.get_shape()...});
+    std::array<std::size_t, sizeof...(Ts)> strides = {{shapes[Is + 1].strides().back()...}};
+    auto ostride = shapes.front().strides().back();
+    auto inner   = shapes.front().lens().back();
+    auto nrows   = shapes.front().elements() / inner;
+    // Split long rows into blocks, so packed tensors can still run in parallel
+    auto block   = std::min(inner, min_elements);
+    auto nblocks = (inner + block - 1) / block;
+    auto run     = [&](auto os, auto... ss) {
+        par_for(nrows * nblocks, std::max<std::size_t>(1, min_elements / block), [&](auto i) {
+            auto start = (i / nblocks) * inner + (i % nblocks) * block;
+            auto n     = std::min(block, inner - (i % nblocks) * block);
+            auto* y    = output.data() + shapes.front().index(start);
+            auto xs    = std::make_tuple((inputs.data() + shapes[Is + 1].index(start))...);
+            for(std::size_t j = 0; j < n; j++)
+                y[j * os] = f(std::get<Is>(xs)[j * ss]...);
+        });
+    };
+    if(ostride == 1 and std::all_of(strides.begin(), strides.end(), [](auto s) { return s < 2; }))
+        visit_unit_strides(
+            strides.data(), [&](auto... ss) { run(unit_stride{}, ss...); }, inputs...);
+    else
+        run(ostride, strides[Is]...);
+}
+
+} // namespace detail
+
+// Apply `f` to the elements of the inputs and write the results to the output. The tensors have
+// the same lens but can be broadcasted or transposed, the dimensions are collapsed with
+// reduce_dims and each row is processed with a contiguous loop.
+template <class T, class F, class... Ts>
+void par_transform(tensor_view<T> output, F f, tensor_view<Ts>... inputs)
+{
+    if(output.get_shape().elements() == 0)
+        return;
+    detail::par_transform_impl(std::index_sequence_for<Ts...>{}, output, f, inputs...);
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -9,6 +9,9 @@ namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_MEMORY_COLORING)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_ENABLE_MEMORY_PACKING)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_MEMORY_COLORING)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_ENABLE_REDUCE_PEAK_MEMORY)
 
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
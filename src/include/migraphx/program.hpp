@@ -22,6 +22,7 @@ MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_COMPILE)
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_EVAL)
 
 struct program_impl;
+struct execution_session_impl;
 
 struct marker;
 
@@ -72,8 +73,14 @@ struct program
 
     void mark(const parameter_map& params, marker&& m);
 
+    /// Summarize the scratch memory, literals and parameters of each module, along with the
+    /// `n` largest tensors that are live when the most bytes are live
+    value memory_report(std::size_t n = 10) const;
+
     value to_value() const;
     void from_value(const value& v);
+    /// Same as from_value, but the literals are created from their value with `read_literal`
+    void from_value(const value& v, const std::function<literal(const value&)>& read_literal);
 
     void debug_print() const;
     void debug_print(instruction_ref ins) const;
@@ -113,10 +120,39 @@ struct program
     void remove_unused_modules();
 
     private:
+    friend struct execution_session;
     void assign(const program& p);
     std::unique_ptr<program_impl> impl;
 };
 
+/**
+ * @brief An independent executor of a compiled program
+ *
+ * A session shares the instructions, literals and execution plan of the program it is created
+ * from, but owns its own context and its own copy of every operator that needs finalizing, so
+ * per-execution state such as preallocated scratch memory is not shared between sessions.
+ *
+ * Different sessions of the same program can be evaluated concurrently from different threads.
+ * A single session must only be used by one thread at a time. The program must outlive its
+ * sessions and must not be modified while they exist.
+ */
+struct execution_session
+{
+    explicit execution_session(const program& p);
+
+    execution_session(execution_session&&) noexcept;
+    execution_session& operator=(execution_session&&) noexcept;
+
+    ~execution_session() noexcept;
+
+    std::vector<argument> eval(parameter_map params);
+
+    context& get_context() const;
+
+    private:
+    std::unique_ptr<execution_session_impl> impl;
+};
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
 
@@ -17,6 +17,8 @@ struct program;
 
 void quantize_fp16(program& prog, const std::vector<std::string>& ins_names = {"all"});
 
+void quantize_bf16(program& prog, const std::vector<std::string>& ins_names = {"all"});
+
 void quantize_int8(program& prog,
                    const target& t,
                    const std::vector<parameter_map>& calibration,
@@ -21,6 +21,16 @@ struct quantize_fp16_pass
     void apply(module& m) const;
 };
 
+/**
+ * quantize a program to bf16
+ */
+struct quantize_bf16_pass
+{
+    std::vector<std::string> ins_names = {"all"};
+    std::string name() const { return "quantize_bf16"; }
+    void apply(module& m) const;
+};
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
 
@@ -0,0 +1,28 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_REDUCE_PEAK_MEMORY_HPP
+#define MIGRAPHX_GUARD_RTGLIB_REDUCE_PEAK_MEMORY_HPP
+
+#include <string>
+#include <migraphx/config.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct module;
+
+/**
+ * Reorder the instructions to reduce the most bytes that are live at the same time. The
+ * allocations are moved to just before their first use, and the module is only changed when the
+ * peak is reduced.
+ */
+struct reduce_peak_memory
+{
+    std::string allocation_op{};
+    bool enable = true;
+    std::string name() const { return "reduce_peak_memory"; }
+    void apply(module& m) const;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -18,6 +18,9 @@ struct schedule
 {
     schedule_model model{};
     bool enable = true;
+    // Assign the streams without sorting the instructions, so the order from an earlier pass such
+    // as reduce_peak_memory is kept
+    bool keep_order = false;
     std::string name() const { return "schedule"; }
     void apply(module& p) const;
 };
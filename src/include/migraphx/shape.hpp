@@ -1,6 +1,9 @@
 #ifndef MIGRAPHX_GUARD_MIGRAPHLIB_SHAPE_HPP
 #define MIGRAPHX_GUARD_MIGRAPHLIB_SHAPE_HPP
 
+#include <algorithm>
+#include <array>
+#include <iterator>
 #include <vector>
 #include <cassert>
 #include <ostream>
@@ -8,6 +11,7 @@
 #include <memory>
 
 #include <migraphx/errors.hpp>
+#include <migraphx/bf16.hpp>
 #include <migraphx/half.hpp>
 #include <migraphx/config.hpp>
 
@@ -16,6 +20,73 @@ inline namespace MIGRAPHX_INLINE_NS {
 
 struct value;
 struct shape_impl;
+struct shape;
+
+/// A multi-index into the lens of a shape. The indices are stored inline for up to
+/// `max_inline_size` dimensions, so creating and copying an index does not allocate.
+struct multi_index
+{
+    static constexpr std::size_t max_inline_size = 8;
+
+    multi_index() = default;
+    /// Create an index of `n` dimensions, which are all zero
+    explicit multi_index(std::size_t n) : m_size(n)
+    {
+        if(n > max_inline_size)
+            heap_data.resize(n);
+    }
+    /// Create the index of the element `i` of the shape, in the standard order of its lens
+    multi_index(const shape& s, std::size_t i);
+
+    template <class Iterator, class = decltype(*std::declval<Iterator>())>
+    multi_index(Iterator start, Iterator last) : multi_index(std::distance(start, last))
+    {
+        std::copy(start, last, begin());
+    }
+
+    std::size_t size() const { return m_size; }
+
+    std::size_t* data() { return m_size > max_inline_size ? heap_data.data() : inline_data.data(); }
+    const std::size_t* data() const
+    {
+        return m_size > max_inline_size ? heap_data.data() : inline_data.data();
+    }
+
+    std::size_t* begin() { return data(); }
+    const std::size_t* begin() const { return data(); }
+
+    std::size_t* end() { return data() + size(); }
+    const std::size_t* end() const { return data() + size(); }
+
+    std::size_t& operator[](std::size_t i) { return data()[i]; }
+    const std::size_t& operator[](std::size_t i) const { return data()[i]; }
+
+    /// Advance to the next index within `lens` in row-major order, like an odometer. Returns false
+    /// when the index wraps around back to zero.
+    template <class Range>
+    bool increment(const Range& lens)
+    {
+        auto* idx = data();
+        for(std::size_t i = m_size; i > 0; i--)
+        {
+            if(++idx[i - 1] < lens[i - 1])
+                return true;
+            idx[i - 1] = 0;
+        }
+        return false;
+    }
+
+    friend bool operator==(const multi_index& x, const multi_index& y)
+    {
+        return std::equal(x.begin(), x.end(), y.begin(), y.end());
+    }
+    friend bool operator!=(const multi_index& x, const multi_index& y) { return not(x == y); }
+
+    private:
+    std::size_t m_size                                   = 0;
+    std::array<std::size_t, max_inline_size> inline_data = {};
+    std::vector<std::size_t> heap_data;
+};
 
 struct shape
 {
@@ -34,7 +105,8 @@ struct shape
     m(int32_type, int32_t) \
     m(int64_type, int64_t) \
     m(uint32_type, uint32_t) \
-    m(uint64_type, uint64_t)
+    m(uint64_type, uint64_t) \
+    m(bf16_type, bf16)
     // clang-format on
 
 #define MIGRAPHX_SHAPE_GENERATE_ENUM_TYPES(x, t) x,
@@ -97,6 +169,8 @@ struct shape
     std::size_t index(std::initializer_list<std::size_t> l) const;
     /// Map multiple indices to space index
     std::size_t index(const std::vector<std::size_t>& l) const;
+    /// Map multiple indices to space index
+    std::size_t index(const multi_index& l) const;
 
     /// Map multiple indices from a range of iterator to a space index
     template <class Iterator>
@@ -11,21 +11,15 @@ inline namespace MIGRAPHX_INLINE_NS {
 template <class F>
 void shape_for_each(const migraphx::shape& s, F f)
 {
-    // Ensure calls to f use const ref to vector
-    auto call = [&f](const std::vector<std::size_t>& i) { f(i); };
-    std::vector<std::size_t> indices(s.lens().size());
-    shape ss{s.type(), s.lens()};
-    for(std::size_t i = 0; i < ss.elements(); i++)
+    // Ensure calls to f use const ref to the index
+    auto call = [&f](const multi_index& i) { f(i); };
+    const auto& lens = s.lens();
+    auto elements    = s.elements();
+    multi_index indices(lens.size());
+    for(std::size_t i = 0; i < elements; i++)
     {
-        std::transform(ss.strides().begin(),
-                       ss.strides().end(),
-                       ss.lens().begin(),
-                       indices.begin(),
-                       [&](std::size_t stride, std::size_t len) {
-                           assert(len > 0 and stride > 0);
-                           return (i / stride) % len;
-                       });
         call(indices);
+        indices.increment(lens);
     }
 }
 
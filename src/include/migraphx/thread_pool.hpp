@@ -0,0 +1,72 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_THREAD_POOL_HPP
+#define MIGRAPHX_GUARD_RTGLIB_THREAD_POOL_HPP
+
+#include <migraphx/config.hpp>
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct thread_pool_impl;
+
+/**
+ * @brief A persistent set of worker threads used to run parallel loops
+ *
+ * Each thread owns a bounded queue of index ranges. A thread running a range splits off half of
+ * it into its queue whenever that queue is empty, and idle threads steal the oldest, and so
+ * largest, ranges from the other queues. The range is thus only split as finely as the load
+ * requires. A thread waiting for a loop to finish runs the remaining ranges of that loop itself,
+ * so parallel loops can be nested without creating more threads than the pool has.
+ */
+struct thread_pool
+{
+    /// Create a pool that runs up to `n` tasks at once, counting the calling thread. When
+    /// `pin_threads` is set each worker is bound to its own cpu.
+    explicit thread_pool(std::size_t n, bool pin_threads = false);
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    ~thread_pool() noexcept;
+
+    /// Maximum number of tasks that run concurrently
+    std::size_t size() const;
+
+    /// Call `f(start, end, tid)` over disjoint ranges covering `[0, n)` and return once all calls
+    /// are finished. Ranges hold at least `grain` indices, except for the last one. The `tid` is
+    /// less than size() and no two calls running at the same time for this loop share it. If any
+    /// call throws, the ranges not yet started are skipped and the first exception is rethrown.
+    template <class F>
+    void parallel_for(std::size_t n, std::size_t grain, F f) const
+    {
+        // Passing a reference keeps std::function from allocating
+        run_ranges(n, grain, std::cref(f));
+    }
+
+    /// Call `f(i)` for every `i` in `[0, n)`
+    template <class F>
+    void run(std::size_t n, F f) const
+    {
+        parallel_for(n, 1, [&](std::size_t start, std::size_t end, std::size_t) {
+            for(std::size_t i = start; i < end; i++)
+                f(i);
+        });
+    }
+
+    /// The process-wide pool. Its size is read from MIGRAPHX_NUM_THREADS, which defaults to the
+    /// number of hardware threads, and its workers are pinned when MIGRAPHX_PIN_THREADS is set.
+    static thread_pool& global();
+
+    private:
+    void run_ranges(std::size_t n,
+                    std::size_t grain,
+                    const std::function<void(std::size_t, std::size_t, std::size_t)>& f) const;
+    std::unique_ptr<thread_pool_impl> impl;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
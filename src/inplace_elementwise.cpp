@@ -0,0 +1,38 @@
+#include <migraphx/inplace_elementwise.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/ranges.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+void inplace_elementwise::apply(module& m) const
+{
+    for(auto ins : iterator_for(m))
+    {
+        if(ins->inputs().size() < 2 or not ins->module_inputs().empty())
+            continue;
+        if(not ins->get_operator().attributes().get("inplace", false))
+            continue;
+        auto alloc = ins->inputs().back();
+        if(alloc->name() != model.name() or not instruction::is_only_used_by(alloc, ins))
+            continue;
+        auto inputs = ins->inputs();
+        auto it     = std::find_if(inputs.begin(), inputs.end() - 1, [&](auto input) {
+            if(input->get_shape() != alloc->get_shape())
+                return false;
+            // The memory of parameters and literals is not owned by the module
+            if(instruction::get_output_alias(input)->name() != model.name())
+                return false;
+            return instruction::is_only_used_by(input, ins);
+        });
+        if(it == inputs.end() - 1)
+            continue;
+        inputs.back() = *it;
+        m.replace_instruction(ins, ins->get_operator(), inputs);
+    }
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -407,6 +407,22 @@ instruction_ref instruction::get_output_alias(instruction_ref ins, bool shallow)
     return get_output_alias(ins->inputs().at(i));
 }
 
+bool instruction::is_only_used_by(instruction_ref x, instruction_ref ins)
+{
+    auto user = ins;
+    while(true)
+    {
+        if(std::any_of(
+               x->outputs().begin(), x->outputs().end(), [&](auto out) { return out != user; }))
+            return false;
+        auto alias = get_output_alias(x, true);
+        if(alias == x)
+            return true;
+        user = x;
+        x    = alias;
+    }
+}
+
 void instruction::set_normalized(bool value) { normalized = value; }
 
 bool instruction::is_normalized() const { return normalized; }
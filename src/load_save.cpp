@@ -2,15 +2,102 @@
 #include <migraphx/file_buffer.hpp>
 #include <migraphx/json.hpp>
 #include <migraphx/msgpack.hpp>
-#include <migraphx/file_buffer.hpp>
+#include <migraphx/mapped_file.hpp>
+#include <migraphx/serialize.hpp>
+#include <cstring>
 #include <fstream>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+// Programs saved as msgpack start with the magic string followed by the size of the header, which
+// is the program as msgpack where the data of each literal is replaced by its offset into the data
+// section. The data section follows the header and starts on a page boundary, so it can be mapped
+// and the literals can refer to it directly.
+static const std::string program_magic = "MIGRAPHX";
+constexpr std::size_t page_alignment    = 4096;
+constexpr std::size_t literal_alignment = 64;
+constexpr std::size_t header_start      = 16;
+
+static std::size_t align_to(std::size_t n, std::size_t alignment)
+{
+    return (n + alignment - 1) / alignment * alignment;
+}
+
+static bool has_program_magic(const char* buffer, std::size_t size)
+{
+    return size >= header_start and
+           std::equal(program_magic.begin(), program_magic.end(), buffer);
+}
+
+// Move the data of the literals out of the value and replace it with its offset into `data`
+static void pack_literals(value& v, std::vector<char>& data)
+{
+    for(auto& mod : v.at("modules"))
+    {
+        for(auto& node : mod.at("nodes"))
+        {
+            if(not node.contains("literal") or not node.at("literal").contains("data"))
+                continue;
+            const auto& bytes = node.at("literal").at("data").get_binary();
+            if(bytes.empty())
+                continue;
+            auto offset = align_to(data.size(), literal_alignment);
+            data.resize(offset);
+            data.insert(data.end(), bytes.begin(), bytes.end());
+            value l;
+            l["shape"]      = node.at("literal").at("shape");
+            l["offset"]     = offset;
+            l["bytes"]      = bytes.size();
+            node["literal"] = l;
+        }
+    }
+}
+
+// Create a literal from its value, where `share` returns a pointer to the data at an offset
+template <class F>
+static literal unpack_literal(const value& v, std::size_t size, F share)
+{
+    if(not v.contains("offset"))
+        return from_value<literal>(v);
+    auto s      = from_value<shape>(v.at("shape"));
+    auto offset = v.at("offset").to<std::size_t>();
+    auto bytes  = v.at("bytes").to<std::size_t>();
+    if(bytes < s.bytes() or offset > size or bytes > size - offset)
+        MIGRAPHX_THROW("Invalid literal data in program file");
+    return share(s, offset);
+}
+
+template <class F>
+static program load_packed(const char* buffer, std::size_t size, F share)
+{
+    std::uint64_t header_size = 0;
+    std::memcpy(&header_size, buffer + program_magic.size(), sizeof(header_size));
+    if(header_size > size - header_start)
+        MIGRAPHX_THROW("Invalid header size in program file");
+    auto data_start = align_to(header_start + header_size, page_alignment);
+    auto data_size  = size > data_start ? size - data_start : 0;
+    program p;
+    p.from_value(from_msgpack(buffer + header_start, header_size), [&](const value& v) {
+        return unpack_literal(v, data_size, [&](const shape& s, std::size_t offset) {
+            return share(s, data_start + offset);
+        });
+    });
+    return p;
+}
+
 program load(const std::string& filename, const file_options& options)
 {
-    return load_buffer(read_buffer(filename), options);
+    mapped_file file{filename};
+    if(options.format == "msgpack" and has_program_magic(file.data(), file.size()))
+    {
+        // Refer to the mapped data, so the weights are only read when they are used and the
+        // pages can be shared between processes loading the same file
+        return load_packed(file.data(), file.size(), [&](const shape& s, std::size_t offset) {
+            return literal{s, file.share(offset)};
+        });
+    }
+    return load_buffer(file.data(), file.size(), options);
 }
 program load_buffer(const std::vector<char>& buffer, const file_options& options)
 {
@@ -21,6 +108,13 @@ program load_buffer(const char* buffer, std::size_t size, const file_options& op
     program p;
     if(options.format == "msgpack")
     {
+        if(has_program_magic(buffer, size))
+        {
+            // The buffer is owned by the caller, so the literals copy their data out of it
+            return load_packed(buffer, size, [&](const shape& s, std::size_t offset) {
+                return literal{s, buffer + offset};
+            });
+        }
         p.from_value(from_msgpack(buffer, size));
     }
     else if(options.format == "json")
@@ -44,7 +138,18 @@ std::vector<char> save_buffer(const program& p, const file_options& options)
     std::vector<char> buffer;
     if(options.format == "msgpack")
     {
-        buffer = to_msgpack(v);
+        std::vector<char> data;
+        pack_literals(v, data);
+        auto header               = to_msgpack(v);
+        std::uint64_t header_size = header.size();
+        auto data_start           = align_to(header_start + header.size(), page_alignment);
+        buffer.reserve(data_start + data.size());
+        buffer.insert(buffer.end(), program_magic.begin(), program_magic.end());
+        buffer.resize(header_start);
+        std::memcpy(buffer.data() + program_magic.size(), &header_size, sizeof(header_size));
+        buffer.insert(buffer.end(), header.begin(), header.end());
+        buffer.resize(data_start);
+        buffer.insert(buffer.end(), data.begin(), data.end());
     }
     else if(options.format == "json")
     {
@@ -0,0 +1,47 @@
+#include <migraphx/mapped_file.hpp>
+#include <migraphx/errors.hpp>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+mapped_file::mapped_file(const std::string& filename)
+{
+    int fd = open(filename.c_str(), O_RDONLY); // NOLINT
+    if(fd < 0)
+        MIGRAPHX_THROW("Error opening file: " + filename);
+    struct stat st = {};
+    if(fstat(fd, &st) != 0 or st.st_size < 1)
+    {
+        close(fd);
+        MIGRAPHX_THROW("Invalid size for: " + filename);
+    }
+    nbytes = st.st_size;
+    // A private writable mapping, so the data can be handed out as a mutable buffer
+    void* p = mmap(nullptr, nbytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file
+    close(fd);
+    if(p == MAP_FAILED) // NOLINT
+        MIGRAPHX_THROW("Error mapping file: " + filename);
+    auto n = nbytes;
+    buffer = std::shared_ptr<char>(static_cast<char*>(p), [n](char* x) { munmap(x, n); });
+}
+
+bool mapped_file::empty() const { return buffer == nullptr; }
+
+const char* mapped_file::data() const { return buffer.get(); }
+
+std::size_t mapped_file::size() const { return nbytes; }
+
+std::shared_ptr<char> mapped_file::share(std::size_t offset) const
+{
+    if(offset > nbytes)
+        MIGRAPHX_THROW("Offset " + std::to_string(offset) + " is past the end of the file");
+    return {buffer, buffer.get() + offset};
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
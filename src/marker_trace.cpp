@@ -0,0 +1,114 @@
+#include <migraphx/marker_trace.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/json.hpp>
+#include <migraphx/value.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct marker_trace
+{
+    using clock = std::chrono::steady_clock;
+
+    struct trace_state
+    {
+        std::ostream* os    = nullptr;
+        const program* prog = nullptr;
+        clock::time_point origin{};
+        std::unordered_map<instruction_ref, std::string> names;
+        std::unordered_map<std::thread::id, std::size_t> threads;
+        // The start of each instruction that has not stopped, which is nested for submodules
+        std::vector<clock::time_point> starts;
+        value events = value::array{};
+    };
+    std::shared_ptr<trace_state> state = std::make_shared<trace_state>();
+
+    explicit marker_trace(std::ostream& os) { state->os = &os; }
+
+    // Microseconds since the program started
+    double timestamp(clock::time_point t) const
+    {
+        return std::chrono::duration<double, std::micro>(t - state->origin).count();
+    }
+
+    std::size_t thread_id() const
+    {
+        auto id = std::this_thread::get_id();
+        return state->threads.emplace(id, state->threads.size()).first->second;
+    }
+
+    value make_event(const std::string& name,
+                     const std::string& category,
+                     clock::time_point start,
+                     clock::time_point stop) const
+    {
+        value event;
+        event["name"] = name;
+        event["cat"]  = category;
+        event["ph"]   = "X";
+        event["ts"]   = timestamp(start);
+        event["dur"]  = timestamp(stop) - timestamp(start);
+        event["pid"]  = 0;
+        event["tid"]  = thread_id();
+        return event;
+    }
+
+    void mark_start(instruction_ref) { state->starts.push_back(clock::now()); }
+    void mark_stop(instruction_ref ins)
+    {
+        // Wait for the instruction to finish so asynchronous targets report the time it ran
+        state->prog->get_context().finish();
+        auto stop  = clock::now();
+        auto start = state->starts.back();
+        state->starts.pop_back();
+
+        std::vector<std::string> inputs;
+        std::transform(ins->inputs().begin(),
+                       ins->inputs().end(),
+                       std::back_inserter(inputs),
+                       [](auto input) { return to_string(input->get_shape()); });
+        value args;
+        args["instruction"] = state->names.at(ins);
+        args["operator"]    = to_string(ins->get_operator());
+        args["shape"]       = to_string(ins->get_shape());
+        args["inputs"]      = inputs;
+        args["bytes"]       = ins->get_shape().bytes();
+
+        auto event    = make_event(ins->name(), "instruction", start, stop);
+        event["args"] = args;
+        state->events.push_back(event);
+    }
+    void mark_start(const program& p)
+    {
+        state->prog = &p;
+        state->names.clear();
+        p.print(state->names, [](auto&&...) {});
+        state->origin = clock::now();
+        state->starts.push_back(state->origin);
+    }
+    void mark_stop(const program&)
+    {
+        auto stop  = clock::now();
+        auto start = state->starts.back();
+        state->starts.pop_back();
+        state->events.push_back(make_event("program", "program", start, stop));
+
+        value result;
+        result["traceEvents"]     = state->events;
+        result["displayTimeUnit"] = "ms";
+        *state->os << to_json_string(result) << std::endl;
+    }
+};
+
+marker create_marker_trace(std::ostream& os) { return marker_trace{os}; }
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -30,6 +30,8 @@ struct module_impl
     std::string name;
     uint32_t nparams = 0;
     bool bypass      = false;
+    // Incremented every time the module is modified
+    std::size_t version = 0;
 
     bool contains(instruction_ref ins) const
     {
@@ -44,6 +46,7 @@ struct module_impl
         // cppcheck-suppress redundantInitialization
         auto r = instructions.emplace(pos, std::forward<Ts>(xs)...);
         instruction_set.insert(std::addressof(*r));
+        version++;
         return r;
     }
     instruction_ref insert(instruction_ref pos, const instruction& ins)
@@ -56,6 +59,7 @@ struct module_impl
         instructions.clear();
         instruction_set.clear();
         nparams = 0;
+        version++;
     }
 
     void push_front(const instruction& ins) { insert(instructions.begin(), ins); }
@@ -77,12 +81,14 @@ struct module_impl
     instruction_ref erase(instruction_ref pos)
     {
         instruction_set.erase(std::addressof(*pos));
+        version++;
         return instructions.erase(pos);
     }
 
     instruction_ref erase(instruction_ref start, instruction_ref last)
     {
         std::for_each(start, last, [&](auto& ins) { instruction_set.erase(std::addressof(ins)); });
+        version++;
         return instructions.erase(start, last);
     }
 };
@@ -112,6 +118,10 @@ std::string module::name() const { return impl->name; }
 bool module::bypass() const { return impl->bypass; }
 void module::set_bypass(bool b) { impl->bypass = b; }
 
+std::size_t module::version() const { return impl->version; }
+
+void module::update_version() { impl->version++; }
+
 void module::assign(const module& m)
 {
     // copy the impl
@@ -219,6 +229,7 @@ instruction_ref module::replace_instruction(instruction_ref ins,
 
     shape r = compute_shape(op, args);
     instruction::replace(ins, op, r, std::move(args));
+    impl->version++;
     assert(ins->valid(begin()));
     return ins;
 }
@@ -232,6 +243,7 @@ instruction_ref module::replace_instruction(instruction_ref ins,
     assert(not starts_with(op.name(), "@"));
     auto out_shape = compute_shape(op, args, module_args);
     instruction::replace(ins, op, out_shape, std::move(args), std::move(module_args));
+    impl->version++;
     assert(ins->valid(begin()));
     return ins;
 }
@@ -252,6 +264,7 @@ instruction_ref module::replace_instruction(instruction_ref ins, instruction_ref
     {
         return rep;
     }
+    impl->version++;
     // Make a copy of outputs which can be changed when calling replace_argument
     auto outputs = ins->outputs();
     for(auto out : outputs)
@@ -298,6 +311,7 @@ instruction_ref module::move_instruction(instruction_ref src, instruction_ref ds
     assert(has_instruction(src));
     assert(has_instruction(dst) or is_end(dst, this->end()));
     impl->instructions.splice(dst, impl->instructions, src);
+    impl->version++;
     return src;
 }
 
@@ -397,6 +411,7 @@ instruction_ref module::replace_return(std::vector<instruction_ref> args)
 
     shape r = compute_shape(last->get_operator(), args);
     instruction::replace(last, last->get_operator(), r, std::move(args));
+    impl->version++;
     assert(last->valid(begin()));
 
     return last;
@@ -553,6 +568,7 @@ instruction_ref module::find_dangling_reference() const
 
 void module::finalize(context& ctx)
 {
+    impl->version++;
     for(auto ins : iterator_for(*this))
     {
         ins->finalize(ctx);
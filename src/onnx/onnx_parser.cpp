@@ -9,7 +9,6 @@
 #include <migraphx/common.hpp>
 #include <migraphx/type_traits.hpp>
 #include <migraphx/float_equal.hpp>
-#include <migraphx/file_buffer.hpp>
 #include <migraphx/filesystem.hpp>
 #include <migraphx/op/unknown.hpp>
 
@@ -361,13 +360,7 @@ literal onnx_parser::parse_tensor(const onnx::TensorProto& t) const
 {
     std::vector<std::size_t> dims(t.dims().begin(), t.dims().end());
     if(not t.external_data().empty())
-    {
-        const std::string& data_file = t.external_data().at(0).value();
-        auto raw_buffer              = read_buffer(path + "/" + data_file);
-        std::string s(raw_buffer.begin(), raw_buffer.end());
-        auto type = get_type(t.data_type());
-        return create_literal(type, dims, s.data());
-    }
+        return parse_external_data(t, dims);
     if(t.has_raw_data())
     {
         const std::string& s = t.raw_data();
@@ -397,6 +390,17 @@ literal onnx_parser::parse_tensor(const onnx::TensorProto& t) const
                        [](uint16_t raw_val) { return *reinterpret_cast<half*>(&raw_val); });
         return create_literal(shape::half_type, dims, data_half);
     }
+    case onnx::TensorProto::BFLOAT16: {
+        // The raw bits are stored in the lower 16 bits of int32_data
+        std::vector<bf16> data_bf16;
+        std::transform(t.int32_data().begin(),
+                       t.int32_data().end(),
+                       std::back_inserter(data_bf16),
+                       [](int32_t raw_val) {
+                           return bf16::from_bits(static_cast<uint16_t>(raw_val));
+                       });
+        return create_literal(shape::bf16_type, dims, data_bf16);
+    }
     case onnx::TensorProto::DOUBLE:
         return create_literal(shape::double_type, dims, t.double_data());
     case onnx::TensorProto::FLOAT: return create_literal(shape::float_type, dims, t.float_data());
@@ -407,6 +411,59 @@ literal onnx_parser::parse_tensor(const onnx::TensorProto& t) const
     }
     MIGRAPHX_THROW("PARSE_TENSOR: Invalid tensor type");
 }
+literal onnx_parser::parse_external_data(const onnx::TensorProto& t,
+                                         const std::vector<std::size_t>& dims) const
+{
+    std::string location;
+    std::size_t offset = 0;
+    std::size_t length = 0;
+    bool has_length    = false;
+    for(auto&& entry : t.external_data())
+    {
+        if(entry.key() == "location")
+        {
+            location = entry.value();
+        }
+        else if(entry.key() == "offset")
+        {
+            offset = std::stoull(entry.value());
+        }
+        else if(entry.key() == "length")
+        {
+            length     = std::stoull(entry.value());
+            has_length = true;
+        }
+    }
+    if(location.empty())
+        MIGRAPHX_THROW("PARSE_EXTERNAL_DATA: No location for tensor: " + t.name());
+
+    auto type = get_type(t.data_type());
+    auto s    = dims.empty() ? shape{type} : shape{type, dims};
+    // empty input
+    if(s.elements() == 0)
+        return {};
+
+    auto file_name = path + "/" + location;
+    auto it        = external_data_files.find(file_name);
+    if(it == external_data_files.end())
+        it = external_data_files.emplace(file_name, mapped_file{file_name}).first;
+    const auto& file = it->second;
+    if(offset > file.size())
+        MIGRAPHX_THROW("PARSE_EXTERNAL_DATA: Offset of tensor " + t.name() + " is past the end of " +
+                       location);
+    if(not has_length)
+        length = file.size() - offset;
+    if(length > file.size() - offset or length < s.bytes())
+        MIGRAPHX_THROW("PARSE_EXTERNAL_DATA: Invalid length for tensor " + t.name() + " in " +
+                       location);
+
+    // Refer to the mapped file directly when the data is aligned for its type, so the weights
+    // are only paged in once they are used
+    if(offset % s.type_size() == 0)
+        return literal{s, file.share(offset)};
+    return literal{s, file.data() + offset};
+}
+
 shape onnx_parser::parse_type(const onnx::TypeProto& t,
                               const std::vector<std::size_t>& input_dims) const
 {
@@ -458,6 +515,7 @@ shape::type_t get_type(int dtype)
     case 11: return shape::double_type;
     case 12: return shape::uint32_type;
     case 13: return shape::uint64_type;
+    case 16: return shape::bf16_type;
     default: {
         MIGRAPHX_THROW("Prototensor data type " + std::to_string(dtype) + " not supported");
     }
@@ -1,12 +1,20 @@
 #include <migraphx/memory_coloring.hpp>
 #include "memory_coloring_impl.hpp"
+#include "memory_packing.hpp"
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
 void memory_coloring::apply(module& p) const
 {
-    if(!enabled(MIGRAPHX_DISABLE_MEMORY_COLORING{}))
+    if(enabled(MIGRAPHX_DISABLE_MEMORY_COLORING{}))
+        return;
+    if(packing or enabled(MIGRAPHX_ENABLE_MEMORY_PACKING{}))
+    {
+        memory_packing_impl opt(&p, allocation_op, alignment, verify);
+        opt.run();
+    }
+    else
     {
         memory_coloring_impl opt(&p, allocation_op, verify);
         opt.run();
@@ -25,6 +25,7 @@ void memory_coloring_impl::run()
             allocate(interval);
             alloc_queue.pop();
         }
+        report_scratch("Memory coloring", required_bytes, get_allocation_intervals());
 
         // rewrite happens after all modules are processed
         rewrite();
@@ -34,6 +35,22 @@ void memory_coloring_impl::run()
     }
 }
 
+std::vector<allocation_interval> memory_coloring_impl::get_allocation_intervals() const
+{
+    std::vector<allocation_interval> result;
+    for(int i = 0; i < num_of_lives; ++i)
+    {
+        const live_interval& interval = live_intervals[i];
+        if(interval.get_begin() == invalid_offset)
+            continue;
+        if(!unify_literals && interval.is_literal)
+            continue;
+        const live_range& segment = interval.segment;
+        result.push_back({segment.begin, segment.end, segment.size, segment.offset});
+    }
+    return result;
+}
+
 bool memory_coloring_impl::allocate(interval_ptr interval)
 {
     shape s          = interval->result;
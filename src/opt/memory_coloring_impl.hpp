@@ -7,6 +7,7 @@
 #include <migraphx/pass_config.hpp>
 #include <migraphx/ranges.hpp>
 #include <migraphx/config.hpp>
+#include "memory_packing.hpp"
 
 #include <set>
 #include <list>
@@ -81,6 +82,7 @@ struct memory_coloring_impl
     void build();
     void run();
     void rewrite();
+    std::vector<allocation_interval> get_allocation_intervals() const;
 
     private:
     static bool is_param(const instruction_ref ins) { return ins->name() == "@param"; }
@@ -0,0 +1,224 @@
+#include <migraphx/module.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/pass_config.hpp>
+#include <migraphx/op/load.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/errors.hpp>
+
+#include "memory_packing.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <unordered_map>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+static const std::size_t unassigned = std::numeric_limits<std::size_t>::max();
+
+std::size_t peak_live_bytes(const std::vector<allocation_interval>& intervals)
+{
+    std::size_t n = 0;
+    for(const auto& interval : intervals)
+        n = std::max(n, interval.end + 2);
+    // The change in the live bytes at each point
+    std::vector<std::ptrdiff_t> deltas(n);
+    for(const auto& interval : intervals)
+    {
+        deltas[interval.begin] += std::ptrdiff_t(interval.size);
+        deltas[interval.end + 1] -= std::ptrdiff_t(interval.size);
+    }
+    std::ptrdiff_t live = 0;
+    std::ptrdiff_t peak = 0;
+    for(auto delta : deltas)
+    {
+        live += delta;
+        peak = std::max(peak, live);
+    }
+    return peak;
+}
+
+void report_scratch(const std::string& planner,
+                    std::size_t scratch_bytes,
+                    const std::vector<allocation_interval>& intervals)
+{
+    if(not enabled(MIGRAPHX_TRACE_MEMORY_COLORING{}))
+        return;
+    auto lower_bound = peak_live_bytes(intervals);
+    std::cout << planner << ": scratch " << scratch_bytes << " bytes, lower bound " << lower_bound
+              << " bytes";
+    if(lower_bound > 0)
+        std::cout << " (" << 100.0 * (scratch_bytes - lower_bound) / lower_bound << "% above)";
+    std::cout << std::endl;
+}
+
+void memory_packing_impl::run()
+{
+    build();
+    if(intervals.empty())
+        return;
+
+    std::vector<std::size_t> by_size(intervals.size());
+    std::iota(by_size.begin(), by_size.end(), 0);
+    std::sort(by_size.begin(), by_size.end(), [&](auto i, auto j) {
+        const auto& x = intervals[i];
+        const auto& y = intervals[j];
+        return std::make_tuple(y.size, y.end - y.begin, x.begin) <
+               std::make_tuple(x.size, x.end - x.begin, y.begin);
+    });
+    // The intervals are already in program order
+    std::vector<std::size_t> by_begin(intervals.size());
+    std::iota(by_begin.begin(), by_begin.end(), 0);
+
+    auto offsets       = pack(by_size);
+    auto scratch_bytes = scratch_size(offsets);
+    auto best_fit      = pack(by_begin);
+    if(scratch_size(best_fit) < scratch_bytes)
+    {
+        offsets       = best_fit;
+        scratch_bytes = scratch_size(best_fit);
+    }
+    for(std::size_t i = 0; i < intervals.size(); i++)
+        intervals[i].offset = offsets[i];
+
+    report_scratch("Memory packing", scratch_bytes, intervals);
+    if(enable_verify)
+        verify();
+    rewrite(scratch_bytes);
+}
+
+void memory_packing_impl::build()
+{
+    auto implicit_deps = p_mod->calc_implicit_deps();
+    std::unordered_map<instruction_ref, std::size_t> interval_index;
+    std::size_t point = 0;
+    for(auto ins : iterator_for(*p_mod))
+    {
+        auto inputs = ins->inputs();
+        if(contains(implicit_deps, ins))
+        {
+            const auto& deps = implicit_deps.at(ins);
+            inputs.insert(inputs.end(), deps.begin(), deps.end());
+        }
+        // An allocation is live until the last use of any instruction that aliases it
+        for(auto input : inputs)
+        {
+            auto it = interval_index.find(instruction::get_output_alias(input));
+            if(it != interval_index.end())
+                intervals[it->second].end = point;
+        }
+        if(ins->name() == allocation_op)
+        {
+            interval_index[ins] = intervals.size();
+            allocations.push_back(ins);
+            intervals.push_back({point, point, ins->get_shape().bytes(), unassigned});
+        }
+        point++;
+    }
+
+    // Sweep the intervals in program order to find the ones that overlap
+    conflicts.resize(intervals.size());
+    std::vector<std::size_t> live;
+    for(std::size_t i = 0; i < intervals.size(); i++)
+    {
+        live.erase(std::remove_if(live.begin(),
+                                  live.end(),
+                                  [&](auto j) { return intervals[j].end < intervals[i].begin; }),
+                   live.end());
+        for(auto j : live)
+        {
+            conflicts[i].push_back(j);
+            conflicts[j].push_back(i);
+        }
+        live.push_back(i);
+    }
+}
+
+std::vector<std::size_t> memory_packing_impl::pack(const std::vector<std::size_t>& order) const
+{
+    auto align = [&](std::size_t x) { return (x + alignment - 1) / alignment * alignment; };
+    std::vector<std::size_t> offsets(intervals.size(), unassigned);
+    std::vector<std::pair<std::size_t, std::size_t>> placed;
+    for(auto i : order)
+    {
+        auto size = intervals[i].size;
+        if(size == 0)
+        {
+            offsets[i] = 0;
+            continue;
+        }
+        placed.clear();
+        for(auto j : conflicts[i])
+        {
+            if(offsets[j] != unassigned and intervals[j].size > 0)
+                placed.emplace_back(offsets[j], offsets[j] + intervals[j].size);
+        }
+        std::sort(placed.begin(), placed.end());
+        // Choose the smallest gap between the overlapping allocations that fits
+        std::size_t offset = unassigned;
+        std::size_t gap    = unassigned;
+        std::size_t top    = 0;
+        for(auto [start, end] : placed)
+        {
+            auto candidate = align(top);
+            if(start >= candidate + size and start - candidate < gap)
+            {
+                offset = candidate;
+                gap    = start - candidate;
+            }
+            top = std::max(top, end);
+        }
+        if(offset == unassigned)
+            offset = align(top);
+        offsets[i] = offset;
+    }
+    return offsets;
+}
+
+std::size_t memory_packing_impl::scratch_size(const std::vector<std::size_t>& offsets) const
+{
+    std::size_t result = 0;
+    for(std::size_t i = 0; i < intervals.size(); i++)
+        result = std::max(result, offsets[i] + intervals[i].size);
+    return result;
+}
+
+void memory_packing_impl::rewrite(std::size_t scratch_bytes)
+{
+    std::vector<std::size_t> dims;
+    dims.push_back((scratch_bytes + sizeof(float) - 1) / sizeof(float));
+    shape s                       = {shape::float_type, dims};
+    instruction_ref scratch_param = p_mod->add_parameter("scratch", s);
+    for(std::size_t i = 0; i < allocations.size(); i++)
+    {
+        auto ins = allocations[i];
+        // Construct the operator directly, since looking it up by name is slow on large modules
+        p_mod->replace_instruction(
+            ins, op::load{ins->get_shape(), intervals[i].offset}, scratch_param);
+    }
+}
+
+void memory_packing_impl::verify() const
+{
+    for(std::size_t i = 0; i < intervals.size(); i++)
+    {
+        const auto& x = intervals[i];
+        if(x.offset % alignment != 0)
+            MIGRAPHX_THROW("Memory packing: allocation is not aligned");
+        for(auto j : conflicts[i])
+        {
+            const auto& y = intervals[j];
+            if(x.size == 0 or y.size == 0)
+                continue;
+            if(x.offset < y.offset + y.size and y.offset < x.offset + x.size)
+                MIGRAPHX_THROW("Memory packing: allocations that are live together overlap");
+        }
+    }
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,65 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_MEMORY_PACKING_HPP
+#define MIGRAPHX_GUARD_RTGLIB_MEMORY_PACKING_HPP
+#include <migraphx/instruction_ref.hpp>
+#include <migraphx/config.hpp>
+
+#include <string>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct module;
+
+// An allocation that is live from the instruction at begin until the instruction at end
+struct allocation_interval
+{
+    std::size_t begin  = 0;
+    std::size_t end    = 0;
+    std::size_t size   = 0;
+    std::size_t offset = 0;
+};
+
+// The most bytes live at the same time, which is a lower bound on the scratch size
+std::size_t peak_live_bytes(const std::vector<allocation_interval>& intervals);
+
+void report_scratch(const std::string& planner,
+                    std::size_t scratch_bytes,
+                    const std::vector<allocation_interval>& intervals);
+
+/**
+ * Assigns the offsets of the allocations by treating them as rectangles to pack in a strip, with
+ * the live range as the width and the size as the height. The allocations are placed in the
+ * smallest gap that fits, either from the largest down or in program order, and the packing that
+ * uses less memory is kept.
+ */
+struct memory_packing_impl
+{
+    memory_packing_impl(module* m, std::string alloc_op, std::size_t align, bool p_verify)
+        : p_mod(m), allocation_op(std::move(alloc_op)), alignment(align), enable_verify(p_verify)
+    {
+    }
+
+    void run();
+
+    private:
+    void build();
+    std::vector<std::size_t> pack(const std::vector<std::size_t>& order) const;
+    std::size_t scratch_size(const std::vector<std::size_t>& offsets) const;
+    void rewrite(std::size_t scratch_bytes);
+    void verify() const;
+
+    module* p_mod;
+    std::string allocation_op{};
+    std::size_t alignment = 1;
+    bool enable_verify;
+
+    std::vector<instruction_ref> allocations;
+    std::vector<allocation_interval> intervals;
+    // The indices of the intervals that overlap each interval
+    std::vector<std::vector<std::size_t>> conflicts;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+#endif
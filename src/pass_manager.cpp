@@ -16,6 +16,20 @@ namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_PASSES);
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TIME_PASSES);
+
+// Apply the pass, and print how long it took when MIGRAPHX_TIME_PASSES is set
+template <class F>
+void time_pass(const std::string& name, F f)
+{
+    if(not enabled(MIGRAPHX_TIME_PASSES{}))
+    {
+        f();
+        return;
+    }
+    auto ms = time<std::chrono::duration<double, std::milli>>(f);
+    std::cout << name << ": " << ms << "ms" << std::endl;
+}
 
 void validate_pass(module& mod, const pass& p, tracer trace)
 {
@@ -37,7 +51,7 @@ void validate_pass(module& mod, const pass& p, tracer trace)
 void run_pass(program& prog, const pass& p, tracer trace)
 {
     trace("Pass: ", p.name());
-    p.apply(prog);
+    time_pass("Pass: " + p.name(), [&] { p.apply(prog); });
     trace(prog);
 }
 
@@ -74,7 +88,9 @@ struct module_pm : module_pass_manager
         assert(mod);
         trace("Module: ", mod->name(), ", Pass: ", p.name());
         assert(mod->validate() == mod->end());
-        p.apply(*this);
+        time_pass("Module: " + mod->name() + ", Pass: " + p.name(), [&] { p.apply(*this); });
+        // Passes can rewire the instructions without going through the module
+        mod->update_version();
         trace(*mod);
         validate_pass(*mod, p, *t);
     }
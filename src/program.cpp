@@ -10,11 +10,20 @@
 #include <migraphx/register_target.hpp>
 #include <migraphx/iterator_for.hpp>
 #include <migraphx/iterator.hpp>
+#include <migraphx/functional.hpp>
 #include <migraphx/algorithm.hpp>
 #include <migraphx/output_iterator.hpp>
 #include <migraphx/make_op.hpp>
 #include <migraphx/marker.hpp>
+#include <migraphx/load_save.hpp>
+#include <migraphx/msgpack.hpp>
+#include <migraphx/filesystem.hpp>
+#include <migraphx/version.h>
+#include <dlfcn.h>
+#include <unistd.h>
 #include <iostream>
+#include <iomanip>
+#include <random>
 #include <sstream>
 #include <algorithm>
 #include <set>
@@ -29,14 +38,176 @@ inline namespace MIGRAPHX_INLINE_NS {
 
 using milliseconds = std::chrono::duration<double, std::milli>;
 
+// A single instruction lowered for evaluation. Everything that can be
+// resolved ahead of time (the normalized operator, input slots, parameter
+// names, literal arguments) is stored here so evaluation only indexes arrays.
+struct eval_step
+{
+    enum step_kind
+    {
+        literal_step,
+        param_step,
+        outline_step,
+        return_step,
+        compute_step
+    };
+    step_kind kind = compute_step;
+    instruction_ref ins;
+    operation op;
+    std::string param_name;
+    argument value;
+    std::size_t output = 0;
+    std::vector<std::size_t> inputs;
+    std::vector<module_ref> module_args;
+    // Index into eval_plan::modules for each of the module_args
+    std::vector<std::size_t> module_plans;
+};
+
+struct module_plan
+{
+    const module* mod = nullptr;
+    // The version of the module when the plan was built
+    std::size_t version    = 0;
+    std::size_t max_inputs = 0;
+    std::vector<eval_step> steps;
+};
+
+// The immutable execution plan of a program. Each instruction of every module
+// is assigned an integer slot so results can be stored in a flat array
+// instead of a map keyed by instruction.
+struct eval_plan
+{
+    std::vector<module_plan> modules;
+    std::size_t slots = 0;
+
+    eval_plan() = default;
+    explicit eval_plan(const std::vector<const module*>& mods)
+    {
+        std::unordered_map<instruction_ref, std::size_t> slot_map;
+        std::unordered_map<const module*, std::size_t> module_map;
+        for(std::size_t i = 0; i < mods.size(); i++)
+        {
+            module_map[mods[i]] = i;
+            for(auto ins : iterator_for(*mods[i]))
+                slot_map[ins] = slots++;
+        }
+        modules.resize(mods.size());
+        std::transform(mods.begin(), mods.end(), modules.begin(), [&](const module* mod) {
+            module_plan mp;
+            mp.mod     = mod;
+            mp.version = mod->version();
+            mp.steps.reserve(mod->size());
+            for(auto ins : iterator_for(*mod))
+            {
+                eval_step step;
+                step.ins    = ins;
+                step.output = slot_map.at(ins);
+                std::transform(ins->inputs().begin(),
+                               ins->inputs().end(),
+                               std::back_inserter(step.inputs),
+                               [&](instruction_ref i) { return slot_map.at(i); });
+                const auto& name = ins->name();
+                if(name == "@literal")
+                {
+                    step.kind  = eval_step::literal_step;
+                    step.value = ins->get_literal().get_argument();
+                }
+                else if(name == "@param")
+                {
+                    step.kind       = eval_step::param_step;
+                    step.param_name = any_cast<builtin::param>(ins->get_operator()).parameter;
+                }
+                else if(name == "@outline")
+                {
+                    step.kind  = eval_step::outline_step;
+                    step.value = argument{ins->get_shape(), nullptr};
+                }
+                else if(name == "@return")
+                {
+                    step.kind = eval_step::return_step;
+                }
+                else
+                {
+                    step.kind        = eval_step::compute_step;
+                    step.op          = ins->normalized_operator();
+                    step.module_args = ins->module_inputs();
+                    std::transform(step.module_args.begin(),
+                                   step.module_args.end(),
+                                   std::back_inserter(step.module_plans),
+                                   [&](module_ref smod) { return module_map.at(smod); });
+                    mp.max_inputs = std::max(mp.max_inputs, step.inputs.size());
+                }
+                mp.steps.push_back(std::move(step));
+            }
+            return mp;
+        });
+    }
+
+    const module_plan& get(const module* mod) const
+    {
+        auto it = std::find_if(
+            modules.begin(), modules.end(), [&](const auto& mp) { return mp.mod == mod; });
+        if(it == modules.end())
+            MIGRAPHX_THROW("Module not found in execution plan: " + mod->name());
+        return *it;
+    }
+
+    // The module was modified after the plan was built
+    bool is_stale() const
+    {
+        return std::any_of(modules.begin(), modules.end(), [](const auto& mp) {
+            return mp.mod->version() != mp.version;
+        });
+    }
+};
+
+// Mutable storage used while evaluating a plan
+struct eval_state
+{
+    std::vector<argument> results;
+    // Scratch input vectors, one per module of the plan
+    std::vector<std::vector<argument>> values;
+    // Operators finalized for this state indexed by slot, empty to use the plan's operators
+    std::vector<operation> ops;
+
+    eval_state() = default;
+    explicit eval_state(const eval_plan& plan) : results(plan.slots), values(plan.modules.size())
+    {
+        for(std::size_t i = 0; i < plan.modules.size(); i++)
+            values[i].reserve(plan.modules[i].max_inputs);
+    }
+};
+
 struct program_impl
 {
     // A map is used to keep references to modules of the program
     std::unordered_map<std::string, module> modules;
     context ctx;
     std::string target_name;
+    // Built by compile and finalize, rebuilt when a module is modified
+    std::shared_ptr<const eval_plan> plan;
 };
 
+static void reset_eval_plan(program_impl& impl)
+{
+    std::atomic_store(&impl.plan, std::shared_ptr<const eval_plan>{});
+}
+
+static std::shared_ptr<const eval_plan> build_eval_plan(const program& p, program_impl& impl)
+{
+    auto plan = std::make_shared<const eval_plan>(p.get_modules());
+    std::atomic_store(&impl.plan, plan);
+    return plan;
+}
+
+static std::shared_ptr<const eval_plan> get_eval_plan(const program& p, program_impl& impl)
+{
+    auto plan = std::atomic_load(&impl.plan);
+    if(plan == nullptr or plan->is_stale())
+        return build_eval_plan(p, impl);
+    return plan;
+}
+
 program::program() : impl(std::make_unique<program_impl>()) { this->create_module("main"); }
 
 program::program(program&&) noexcept = default;
@@ -138,14 +309,176 @@ instruction_ref program::validate() const
 
 bool program::is_compiled() const { return not this->impl->target_name.empty(); }
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_COMPILE_CACHE_DIR)
+
+// The environment variables of the library can change the passes of a target, except for the
+// ones that only trace or that choose the cache directory
+static value compile_env()
+{
+    std::set<std::string> vars;
+    for(char** e = environ; e != nullptr and *e != nullptr; e++)
+    {
+        std::string var = *e;
+        if(not starts_with(var, "MIGRAPHX_") or starts_with(var, "MIGRAPHX_TRACE") or
+           starts_with(var, "MIGRAPHX_COMPILE_CACHE_DIR="))
+            continue;
+        vars.insert(var);
+    }
+    value result = value::array{};
+    for(const auto& var : vars)
+        result.push_back(var);
+    return result;
+}
+
+// Builds of the same version can differ, so the library file itself identifies the build
+static value library_id()
+{
+    value result;
+    Dl_info info;
+    if(dladdr(reinterpret_cast<void*>(&library_id), &info) == 0 or info.dli_fname == nullptr)
+        return result;
+    std::error_code ec;
+    fs::path lib = info.dli_fname;
+    auto size    = fs::file_size(lib, ec);
+    if(ec)
+        return result;
+    auto time = fs::last_write_time(lib, ec);
+    if(ec)
+        return result;
+    result["size"] = std::uint64_t(size);
+    result["time"] = std::int64_t(time.time_since_epoch().count());
+    return result;
+}
+
+// The name of the file is a hash of the program, the target and its context, the compile options,
+// the environment and the build of the library, so a program compiled for another device or by
+// another build is never loaded
+static std::string compile_cache_name(const program& p,
+                                      const target& t,
+                                      const context& ctx,
+                                      const compile_options& options)
+{
+    value v;
+    v["program"]      = p.to_value();
+    v["target"]       = t.name();
+    v["context"]      = ctx.to_value();
+    v["offload_copy"] = options.offload_copy;
+    v["fast_math"]    = options.fast_math;
+    v["env"]          = compile_env();
+    v["version"]      = {MIGRAPHX_VERSION_MAJOR, MIGRAPHX_VERSION_MINOR, MIGRAPHX_VERSION_PATCH};
+    v["tweak"]        = MIGRAPHX_VERSION_TWEAK;
+    v["library"]      = library_id();
+    auto buffer       = to_msgpack(v);
+    // 64-bit FNV-1a
+    std::uint64_t h = 14695981039346656037ULL;
+    for(char c : buffer)
+    {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ULL;
+    }
+    std::stringstream ss;
+    ss << t.name() << "-" << std::hex << std::setw(16) << std::setfill('0') << h << "-"
+       << buffer.size() << ".mxr";
+    return ss.str();
+}
+
+static bool load_compile_cache(program& p, const fs::path& file)
+{
+    std::error_code ec;
+    if(not fs::exists(file, ec))
+        return false;
+    try
+    {
+        p = load(file.string());
+        return true;
+    }
+    catch(const std::exception&)
+    {
+        // Compile again and replace the file
+        return false;
+    }
+}
+
+// Move the modules of the cached program into the modules of the program with the same name, so
+// the module pointers already handed out stay valid. Instructions of the program from before the
+// compile are not kept, as they are after any other compile.
+static void load_in_place(program_impl& impl, program_impl& cached)
+{
+    std::unordered_map<module_ref, module_ref> map_mods;
+    for(auto&& pp : cached.modules)
+    {
+        auto it = impl.modules.find(pp.first);
+        if(it == impl.modules.end())
+            it = impl.modules.emplace(pp.first, module{pp.first}).first;
+        map_mods[&pp.second] = &it->second;
+    }
+    for(auto it = impl.modules.begin(); it != impl.modules.end();)
+    {
+        if(contains(cached.modules, it->first))
+            it++;
+        else
+            it = impl.modules.erase(it);
+    }
+    for(auto&& pp : cached.modules)
+        *map_mods.at(&pp.second) = std::move(pp.second);
+    for(auto&& pp : impl.modules)
+    {
+        for(auto ins : iterator_for(pp.second))
+        {
+            auto mod_args = ins->module_inputs();
+            for(auto* mod : mod_args)
+                instruction::replace_mod_argument(ins, mod, map_mods.at(mod));
+        }
+    }
+    impl.ctx         = cached.ctx;
+    impl.target_name = cached.target_name;
+}
+
+static void save_compile_cache(const program& p, const fs::path& file)
+{
+    std::error_code ec;
+    fs::create_directories(file.parent_path(), ec);
+    // Write to a temporary file first, so other processes never load a partial file
+    auto tmp = file.string() + "." + std::to_string(std::random_device{}()) + ".tmp";
+    try
+    {
+        save(p, tmp);
+    }
+    catch(const std::exception&)
+    {
+        fs::remove(tmp, ec);
+        return;
+    }
+    fs::rename(tmp, file, ec);
+    if(ec)
+        fs::remove(tmp, ec);
+}
+
 void program::compile(const target& t, compile_options options)
 {
     assert(not this->is_compiled());
-    this->impl->target_name = t.name();
-    this->impl->ctx         = t.get_context();
     if(enabled(MIGRAPHX_TRACE_COMPILE{}))
         options.trace = tracer{std::cout};
 
+    auto ctx = t.get_context();
+    fs::path cache_file;
+    auto cache_dir = string_value_of(MIGRAPHX_COMPILE_CACHE_DIR{});
+    if(not cache_dir.empty())
+    {
+        cache_file = fs::path{cache_dir} / compile_cache_name(*this, t, ctx, options);
+        program cached;
+        if(load_compile_cache(cached, cache_file))
+        {
+            load_in_place(*this->impl, *cached.impl);
+            build_eval_plan(*this, *this->impl);
+            options.trace("Loaded compiled program from ", cache_file.string());
+            return;
+        }
+    }
+
+    this->impl->target_name = t.name();
+    this->impl->ctx         = ctx;
+
     options.trace(*this);
     options.trace();
 
@@ -172,12 +505,17 @@ void program::compile(const target& t, compile_options options)
         }
         mod->finalize(this->impl->ctx);
     }
+    build_eval_plan(*this, *this->impl);
+
+    if(not cache_file.empty())
+        save_compile_cache(*this, cache_file);
 }
 
 void program::finalize()
 {
     auto* mm = this->get_main_module();
     mm->finalize(this->impl->ctx);
+    build_eval_plan(*this, *this->impl);
 }
 
 template <class T>
@@ -238,91 +576,90 @@ void preview_argument(std::ostream& os, const argument& a)
 }
 
 template <class F>
-std::vector<argument> generic_eval(const module* mod,
+std::vector<argument> generic_eval(const eval_plan& plan,
+                                   const module_plan& mp,
                                    context& ctx,
-                                   std::unordered_map<std::string, argument> params,
-                                   std::unordered_map<instruction_ref, argument> results,
+                                   const parameter_map& params,
+                                   eval_state& state,
                                    F make_trace)
 {
-    assert(mod->validate() == mod->end());
-    results.reserve(mod->size() * 2);
-    std::vector<argument> values;
-    values.reserve(16);
-    auto trace = make_trace(mod);
-    for(auto ins : iterator_for(*mod))
+    assert(mp.mod->validate() == mp.mod->end());
+    if(mp.steps.empty())
+        return {};
+    auto& results         = state.results;
+    auto& values          = state.values[std::distance(plan.modules.data(), &mp)];
+    auto trace            = make_trace(mp.mod);
+    const eval_step* step = nullptr;
+    auto module_eval_impl = [&](module_ref smod, const parameter_map& inputs) {
+        auto it = std::find(step->module_args.begin(), step->module_args.end(), smod);
+        const auto& smp =
+            it == step->module_args.end()
+                ? plan.get(smod)
+                : plan.modules[step->module_plans[it - step->module_args.begin()]];
+        auto ssctx = ctx;
+        return generic_eval(plan, smp, ssctx, inputs, state, make_trace);
+    };
+    // Only capture a pointer so the std::function does not need to allocate
+    std::function<std::vector<argument>(module_ref&, const parameter_map&)> module_eval =
+        [p = &module_eval_impl](module_ref& smod, const parameter_map& inputs) {
+            return (*p)(smod, inputs);
+        };
+    for(const auto& s : mp.steps)
     {
-        assert(results.find(ins) == results.end());
-        const auto& name = ins->name();
-        if(name == "@literal")
-        {
-            results.emplace(ins, trace(ins, [&] { return ins->get_literal().get_argument(); }));
-        }
-        else if(name == "@param")
-        {
-            results.emplace(
-                ins, trace(ins, [&] {
-                    auto param_name = any_cast<builtin::param>(ins->get_operator()).parameter;
-                    if(not contains(params, param_name))
-                        MIGRAPHX_THROW("Parameter not found: " + param_name);
-                    auto param = params[param_name];
-                    if(param.get_shape() != ins->get_shape())
-                        MIGRAPHX_THROW("Incorrect shape {" + to_string(param.get_shape()) +
-                                       "} for parameter: " + param_name);
-                    return param;
-                }));
-        }
-        else if(name == "@outline")
-        {
-            results.emplace(ins, trace(ins, [&] { return argument{ins->get_shape(), nullptr}; }));
-        }
-        else if(name == "@return")
+        step     = &s;
+        auto ins = s.ins;
+        switch(s.kind)
         {
+        case eval_step::literal_step:
+        case eval_step::outline_step:
+            results[s.output] = trace(ins, [&] { return s.value; });
+            break;
+        case eval_step::param_step:
+            results[s.output] = trace(ins, [&] {
+                auto param = params.find(s.param_name);
+                if(param == params.end())
+                    MIGRAPHX_THROW("Parameter not found: " + s.param_name);
+                if(param->second.get_shape() != ins->get_shape())
+                    MIGRAPHX_THROW("Incorrect shape {" + to_string(param->second.get_shape()) +
+                                   "} for parameter: " + s.param_name);
+                return param->second;
+            });
+            break;
+        case eval_step::return_step: {
             std::vector<argument> prog_outputs;
-            std::transform(ins->inputs().begin(),
-                           ins->inputs().end(),
+            prog_outputs.reserve(s.inputs.size());
+            std::transform(s.inputs.begin(),
+                           s.inputs.end(),
                            std::back_inserter(prog_outputs),
-                           [&](instruction_ref i) {
-                               assert(results.find(i) != results.end());
-                               return results[i];
-                           });
-
+                           [&](std::size_t i) { return results[i]; });
             return prog_outputs;
         }
-        else
-        {
-            values.resize(ins->inputs().size());
-            std::transform(
-                ins->inputs().begin(), ins->inputs().end(), values.begin(), [&](instruction_ref i) {
-                    assert(results.find(i) != results.end());
-                    return results[i];
-                });
-
-            const auto& mod_args = ins->module_inputs();
-            auto module_eval     = [&](module_ref smod,
-                                   const std::unordered_map<std::string, argument>& inputs) {
-                auto ssctx = ctx;
-                return generic_eval(smod, ssctx, inputs, results, make_trace);
-            };
-
-            results.emplace(ins, trace(ins, [&] {
-                                return ins->normalized_operator().compute(
-                                    ctx, ins->get_shape(), values, mod_args, module_eval);
-                            }));
+        case eval_step::compute_step:
+            values.resize(s.inputs.size());
+            std::transform(s.inputs.begin(), s.inputs.end(), values.begin(), [&](std::size_t i) {
+                return results[i];
+            });
+            results[s.output] = trace(ins, [&] {
+                const auto& op = state.ops.empty() ? s.op : state.ops[s.output];
+                return op.compute(ctx, ins->get_shape(), values, s.module_args, module_eval);
+            });
+            break;
         }
-        assert(results.find(ins) != results.end());
-        assert(results.at(ins).get_shape() == ins->get_shape());
+        assert(results[s.output].get_shape() == ins->get_shape());
     }
-    return {results.at(std::prev(mod->end()))};
+    return {results[mp.steps.back().output]};
 }
 
 template <class F>
 std::vector<argument> generic_eval(const program& p,
+                                   program_impl& impl,
                                    context& ctx,
-                                   std::unordered_map<std::string, argument> params,
+                                   const parameter_map& params,
                                    F make_trace)
 {
-    const module* mm = p.get_main_module();
-    return generic_eval(mm, ctx, params, {}, make_trace);
+    auto plan = get_eval_plan(p, impl);
+    eval_state state{*plan};
+    return generic_eval(*plan, plan->get(p.get_main_module()), ctx, params, state, make_trace);
 }
 
 std::vector<argument> program::eval(parameter_map params) const
@@ -362,8 +699,9 @@ std::vector<argument> program::eval(parameter_map params) const
         });
 
         return generic_eval(*this,
+                            *this->impl,
                             ctx,
-                            std::move(params),
+                            params,
                             with_check_context([&](auto& ins, auto f, auto&& check_context) {
                                 ctx.finish();
                                 std::cout << "Run instruction: " << ins_out.at(ins) << std::endl;
@@ -398,14 +736,76 @@ std::vector<argument> program::eval(parameter_map params) const
     else
     {
         return generic_eval(*this,
+                            *this->impl,
                             ctx,
-                            std::move(params),
+                            params,
                             with_check_context([&](auto&, auto f, auto&& check_context) {
                                 return check_context(f);
                             }));
     }
 }
 
+struct execution_session_impl
+{
+    const program* prog = nullptr;
+    std::shared_ptr<const eval_plan> plan;
+    context ctx;
+    eval_state state;
+};
+
+static context make_session_context(const program_impl& impl)
+{
+    if(contains(get_targets(), impl.target_name))
+    {
+        auto ctx = make_target(impl.target_name).get_context();
+        ctx.from_value(impl.ctx.to_value());
+        return ctx;
+    }
+    // The context is copied on write so this will be cloned on first use
+    return impl.ctx;
+}
+
+execution_session::execution_session(const program& p)
+    : impl(std::make_unique<execution_session_impl>())
+{
+    impl->prog  = &p;
+    impl->plan  = get_eval_plan(p, *p.impl);
+    impl->ctx   = make_session_context(*p.impl);
+    impl->state = eval_state{*impl->plan};
+    impl->state.ops.resize(impl->plan->slots);
+    for(const auto& mp : impl->plan->modules)
+    {
+        for(const auto& step : mp.steps)
+        {
+            if(step.kind != eval_step::compute_step)
+                continue;
+            auto& op = impl->state.ops[step.output];
+            op       = step.op;
+            // Finalizing clones the operator so any state it allocates belongs to this session
+            if(has_finalize(op))
+                op.finalize(impl->ctx, step.ins->get_shape(), to_shapes(step.ins->inputs()));
+        }
+    }
+}
+
+execution_session::execution_session(execution_session&&) noexcept = default;
+execution_session::~execution_session() noexcept                   = default;
+
+execution_session& execution_session::operator=(execution_session&&) noexcept = default;
+
+std::vector<argument> execution_session::eval(parameter_map params)
+{
+    const auto& plan = *impl->plan;
+    return generic_eval(plan,
+                        plan.get(impl->prog->get_main_module()),
+                        impl->ctx,
+                        params,
+                        impl->state,
+                        always([](auto&&, auto f) { return f(); }));
+}
+
+context& execution_session::get_context() const { return impl->ctx; }
+
 const int program_file_version = 5;
 
 value program::to_value() const
@@ -469,7 +869,8 @@ value program::to_value() const
 static void mod_from_val(module_ref mod,
                          const value& v,
                          std::unordered_map<std::string, instruction_ref>& instructions,
-                         const std::unordered_map<std::string, module_ref>& map_mods)
+                         const std::unordered_map<std::string, module_ref>& map_mods,
+                         const std::function<literal(const value&)>& read_literal)
 {
     const auto& module_val = v.at(mod->name());
     for(const value& node : module_val.at("nodes"))
@@ -486,7 +887,7 @@ static void mod_from_val(module_ref mod,
         }
         else if(name == "@literal")
         {
-            output = mod->add_literal(migraphx::from_value<literal>(node.at("literal")));
+            output = mod->add_literal(read_literal(node.at("literal")));
         }
         else
         {
@@ -511,7 +912,7 @@ static void mod_from_val(module_ref mod,
 
                 for(auto& smod : module_inputs)
                 {
-                    mod_from_val(smod, v, instructions, map_mods);
+                    mod_from_val(smod, v, instructions, map_mods, read_literal);
                 }
             }
 
@@ -534,6 +935,11 @@ static void mod_from_val(module_ref mod,
 }
 
 void program::from_value(const value& v)
+{
+    this->from_value(v, [](const value& x) { return migraphx::from_value<literal>(x); });
+}
+
+void program::from_value(const value& v, const std::function<literal(const value&)>& read_literal)
 {
     auto version = v.at("version").to<int>();
     if(version != program_file_version)
@@ -565,7 +971,7 @@ void program::from_value(const value& v)
 
     std::unordered_map<std::string, instruction_ref> map_insts;
     auto* mm = get_main_module();
-    mod_from_val(mm, module_vals, map_insts, map_mods);
+    mod_from_val(mm, module_vals, map_insts, map_mods, read_literal);
 
     this->finalize();
 }
@@ -593,7 +999,7 @@ void program::mark(const parameter_map& params, marker&& m)
     ctx.finish();
     // Start marking
     m.mark_start(*this);
-    generic_eval(*this, ctx, params, always([&](auto ins, auto f) {
+    generic_eval(*this, *this->impl, ctx, params, always([&](auto ins, auto f) {
         argument result;
         m.mark_start(ins);
         result = f();
@@ -625,7 +1031,7 @@ void program::perf_report(std::ostream& os,
     std::sort(total_vec.begin(), total_vec.end());
     std::unordered_map<instruction_ref, std::vector<double>> ins_vec;
     // Fill the map
-    generic_eval(*this, ctx, params, always([&](auto ins, auto) {
+    generic_eval(*this, *this->impl, ctx, params, always([&](auto ins, auto) {
         ins_vec[ins].reserve(n);
         return argument{ins->get_shape(), nullptr};
     }));
@@ -633,7 +1039,7 @@ void program::perf_report(std::ostream& os,
     // Run and time each instruction
     for(std::size_t i = 0; i < n; i++)
     {
-        generic_eval(*this, ctx, params, always([&](auto ins, auto f) {
+        generic_eval(*this, *this->impl, ctx, params, always([&](auto ins, auto f) {
             argument result;
             ins_vec[ins].push_back(time<milliseconds>([&] {
                 result = f();
@@ -709,6 +1115,158 @@ void program::perf_report(std::ostream& os,
        << ", " << std::round(calculate_overhead_percent) << "%" << std::endl;
 }
 
+// The instruction that owns the memory an instruction writes to, which is either a `load` from
+// the scratch memory or an instruction that does not alias any of its inputs
+static instruction_ref memory_owner(instruction_ref ins)
+{
+    while(ins->name() != "load")
+    {
+        auto alias = instruction::get_output_alias(ins, true);
+        if(alias == ins)
+            break;
+        ins = alias;
+    }
+    return ins;
+}
+
+// The targets copy the literals into their own memory with an operator that has the literal
+// attribute
+static bool is_literal(instruction_ref ins)
+{
+    return ins->name() == "@literal" or ins->get_operator().attributes().get("literal", false);
+}
+
+static value module_memory_report(const module& m, std::size_t n)
+{
+    value result;
+    std::size_t literal_bytes   = 0;
+    std::size_t literals        = 0;
+    std::size_t parameter_bytes = 0;
+    std::size_t scratch_bytes   = 0;
+    std::unordered_set<instruction_ref> scratch_params;
+    // The first and last position each buffer is used
+    std::unordered_map<instruction_ref, std::pair<std::size_t, std::size_t>> intervals;
+    std::vector<instruction_ref> buffers;
+    auto implicit_deps = m.calc_implicit_deps();
+    std::size_t i      = 0;
+    for(auto ins : iterator_for(m))
+    {
+        auto inputs = ins->inputs();
+        if(contains(implicit_deps, ins))
+        {
+            const auto& deps = implicit_deps.at(ins);
+            inputs.insert(inputs.end(), deps.begin(), deps.end());
+        }
+        for(auto input : inputs)
+        {
+            auto it = intervals.find(memory_owner(input));
+            if(it != intervals.end())
+                it->second.second = i;
+        }
+        if(is_literal(ins))
+        {
+            literal_bytes += ins->get_shape().bytes();
+            literals++;
+        }
+        else if(ins->name() == "load")
+        {
+            auto offset   = ins->get_operator().to_value().at("offset").to<std::size_t>();
+            scratch_bytes = std::max(scratch_bytes, offset + ins->get_shape().bytes());
+            scratch_params.insert(ins->inputs().front());
+        }
+        if(not starts_with(ins->name(), "@") and not is_literal(ins) and memory_owner(ins) == ins)
+        {
+            intervals[ins] = std::make_pair(i, i);
+            buffers.push_back(ins);
+        }
+        i++;
+    }
+    // The scratch memory, which the targets preallocate with an operator, is reported through the
+    // loads from it
+    buffers.erase(std::remove_if(buffers.begin(),
+                                 buffers.end(),
+                                 [&](auto ins) { return contains(scratch_params, ins); }),
+                  buffers.end());
+    for(auto ins : iterator_for(m))
+    {
+        if(ins->name() == "@param" and not contains(scratch_params, ins))
+            parameter_bytes += ins->get_shape().bytes();
+    }
+
+    // Find the position where the most bytes are live
+    std::vector<std::ptrdiff_t> deltas(i + 1);
+    for(auto ins : buffers)
+    {
+        auto interval = intervals.at(ins);
+        auto bytes    = std::ptrdiff_t(ins->get_shape().bytes());
+        deltas[interval.first] += bytes;
+        deltas[interval.second + 1] -= bytes;
+    }
+    std::ptrdiff_t live       = 0;
+    std::ptrdiff_t peak       = 0;
+    std::size_t peak_position = 0;
+    for(std::size_t j = 0; j < deltas.size(); j++)
+    {
+        live += deltas[j];
+        if(live <= peak)
+            continue;
+        peak          = live;
+        peak_position = j;
+    }
+    std::vector<instruction_ref> live_at_peak;
+    std::copy_if(buffers.begin(), buffers.end(), std::back_inserter(live_at_peak), [&](auto ins) {
+        auto interval = intervals.at(ins);
+        return interval.first <= peak_position and peak_position <= interval.second;
+    });
+    std::stable_sort(live_at_peak.begin(), live_at_peak.end(), by(std::greater<>{}, [](auto ins) {
+                         return ins->get_shape().bytes();
+                     }));
+    if(live_at_peak.size() > n)
+        live_at_peak.resize(n);
+
+    auto names = m.print([](auto&&...) {}, {});
+    value top  = value::array{};
+    for(auto ins : live_at_peak)
+    {
+        value tensor;
+        tensor["instruction"] = names.at(ins);
+        tensor["operator"]    = ins->name();
+        tensor["shape"]       = to_string(ins->get_shape());
+        tensor["bytes"]       = ins->get_shape().bytes();
+        if(ins->name() == "load")
+            tensor["offset"] = ins->get_operator().to_value().at("offset");
+        top.push_back(tensor);
+    }
+
+    result["name"]            = m.name();
+    result["scratch_bytes"]   = scratch_bytes;
+    result["peak_bytes"]      = std::size_t(peak);
+    result["literal_bytes"]   = literal_bytes;
+    result["literals"]        = literals;
+    result["parameter_bytes"] = parameter_bytes;
+    result["live_at_peak"]    = top;
+    return result;
+}
+
+value program::memory_report(std::size_t n) const
+{
+    value result;
+    value module_reports      = value::array{};
+    std::size_t scratch_bytes = 0;
+    std::size_t literal_bytes = 0;
+    for(const auto* mod : this->get_modules())
+    {
+        auto report = module_memory_report(*mod, n);
+        scratch_bytes += report.at("scratch_bytes").to<std::size_t>();
+        literal_bytes += report.at("literal_bytes").to<std::size_t>();
+        module_reports.push_back(report);
+    }
+    result["scratch_bytes"] = scratch_bytes;
+    result["literal_bytes"] = literal_bytes;
+    result["modules"]       = module_reports;
+    return result;
+}
+
 void program::debug_print() const { std::cout << *this << std::endl; }
 void program::debug_print(instruction_ref ins) const
 {
@@ -778,7 +1336,7 @@ void program::print_cpp(std::ostream& os) const
 void program::dry_run(std::unordered_map<std::string, argument> params) const
 {
     auto& ctx = this->impl->ctx;
-    generic_eval(*this, ctx, std::move(params), always([](auto ins, auto&&...) {
+    generic_eval(*this, *this->impl, ctx, params, always([](auto ins, auto&&...) {
         return argument{ins->get_shape(), nullptr};
     }));
 }
@@ -797,6 +1355,7 @@ const module* program::get_module(const std::string& name) const { return &impl-
 module* program::create_module(const std::string& name)
 {
     assert(not contains(impl->modules, name));
+    reset_eval_plan(*impl);
     auto r = impl->modules.emplace(name, name);
     return &(r.first->second);
 }
@@ -898,6 +1457,7 @@ void program::remove_module(const std::string& name)
     }
 
     impl->modules.erase(name);
+    reset_eval_plan(*impl);
 }
 
 void program::remove_unused_modules()
@@ -911,6 +1471,7 @@ void program::remove_unused_modules()
 
 program& program::sort()
 {
+    reset_eval_plan(*impl);
     for(auto& pp : this->impl->modules)
     {
         pp.second.sort();
@@ -17,6 +17,8 @@
 #include <migraphx/register_target.hpp>
 #include <migraphx/json.hpp>
 #include <migraphx/make_op.hpp>
+#include <migraphx/marker_trace.hpp>
+#include <fstream>
 
 #ifdef HAVE_GPU
 #include <migraphx/gpu/hip.hpp>
@@ -116,6 +118,18 @@ struct npy_format_descriptor<half>
     static constexpr auto name() { return _("half"); }
 };
 
+template <>
+struct npy_format_descriptor<migraphx::bf16>
+{
+    static std::string format()
+    {
+        // There is no format character for bfloat16 that numpy understands, so expose the bits as
+        // uint16
+        return "H";
+    }
+    static constexpr auto name() { return _("bf16"); }
+};
+
 } // namespace detail
 } // namespace pybind11
 
@@ -175,6 +189,9 @@ migraphx::shape to_shape(const py::buffer_info& info)
     migraphx::shape::type_t t;
     std::size_t n = 0;
     visit_types([&](auto as) {
+        // bf16 has the same format as uint16, so the parameters decide when to use it
+        if(as.type_enum() == migraphx::shape::bf16_type)
+            return;
         if(info.format == py::format_descriptor<decltype(as())>::format() or
            (info.format == "l" and py::format_descriptor<decltype(as())>::format() == "q") or
            (info.format == "L" and py::format_descriptor<decltype(as())>::format() == "Q"))
@@ -210,6 +227,25 @@ migraphx::shape to_shape(const py::buffer_info& info)
     }
 }
 
+migraphx::parameter_map to_parameter_map(const py::dict& params, const migraphx::program& p)
+{
+    auto param_shapes = p.get_parameter_shapes();
+    migraphx::parameter_map pm;
+    for(auto x : params)
+    {
+        std::string key      = x.first.cast<std::string>();
+        py::buffer b         = x.second.cast<py::buffer>();
+        py::buffer_info info = b.request();
+        auto s               = to_shape(info);
+        // bf16 is passed as the uint16 bits
+        if(s.type() == migraphx::shape::uint16_type and param_shapes.count(key) > 0 and
+           param_shapes.at(key).type() == migraphx::shape::bf16_type)
+            s = migraphx::shape{migraphx::shape::bf16_type, s.lens(), s.strides()};
+        pm[key] = migraphx::argument(s, info.ptr);
+    }
+    return pm;
+}
+
 MIGRAPHX_PYBIND11_MODULE(migraphx, m)
 {
     py::class_<migraphx::shape>(m, "shape")
@@ -311,17 +347,25 @@ MIGRAPHX_PYBIND11_MODULE(migraphx, m)
             py::arg("name"))
         .def("run",
              [](migraphx::program& p, py::dict params) {
-                 migraphx::parameter_map pm;
-                 for(auto x : params)
-                 {
-                     std::string key      = x.first.cast<std::string>();
-                     py::buffer b         = x.second.cast<py::buffer>();
-                     py::buffer_info info = b.request();
-                     pm[key]              = migraphx::argument(to_shape(info), info.ptr);
-                 }
-                 return p.eval(pm);
+                 return p.eval(to_parameter_map(params, p));
              })
+        .def(
+            "trace",
+            [](migraphx::program& p, py::dict params, const std::string& filename) {
+                std::ofstream os(filename);
+                if(not os)
+                    MIGRAPHX_THROW("Failed to open file: " + filename);
+                p.mark(to_parameter_map(params, p), migraphx::create_marker_trace(os));
+            },
+            py::arg("params"),
+            py::arg("filename"))
         .def("sort", &migraphx::program::sort)
+        .def(
+            "memory_report",
+            [](const migraphx::program& p, std::size_t n) {
+                return migraphx::to_json_string(p.memory_report(n));
+            },
+            py::arg("n") = 10)
         .def("print", [](const migraphx::program& p) { std::cout << p << std::endl; })
         .def("__eq__", std::equal_to<migraphx::program>{})
         .def("__ne__", std::not_equal_to<migraphx::program>{})
@@ -431,6 +475,10 @@ MIGRAPHX_PYBIND11_MODULE(migraphx, m)
           &migraphx::quantize_fp16,
           py::arg("prog"),
           py::arg("ins_names") = std::vector<std::string>{"all"});
+    m.def("quantize_bf16",
+          &migraphx::quantize_bf16,
+          py::arg("prog"),
+          py::arg("ins_names") = std::vector<std::string>{"all"});
     m.def("quantize_int8",
           &migraphx::quantize_int8,
           py::arg("prog"),
@@ -40,6 +40,19 @@ void quantize_fp16(program& prog, const std::vector<std::string>& ins_names)
                 dead_code_elimination{}});
 }
 
+// bf16 has the same range as float, so only the precision is reduced
+void quantize_bf16(program& prog, const std::vector<std::string>& ins_names)
+{
+    run_passes(prog,
+               {quantize_bf16_pass{ins_names},
+                eliminate_common_subexpression{},
+                dead_code_elimination{},
+                simplify_reshapes{},
+                dead_code_elimination{},
+                simplify_qdq{},
+                dead_code_elimination{}});
+}
+
 void quantize_int8(program& prog,
                    const target& t,
                    const std::vector<parameter_map>& calibration,
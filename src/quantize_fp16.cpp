@@ -12,7 +12,8 @@
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
-static void quantize_module(module& m, const std::vector<std::string>& ins_names)
+static void
+quantize_module(module& m, const std::vector<std::string>& ins_names, shape::type_t type)
 {
     for(auto ins : iterator_for(m))
     {
@@ -37,14 +38,13 @@ static void quantize_module(module& m, const std::vector<std::string>& ins_names
             m.replace_instruction(ins, r);
         }
 
-        // Convert each of the inputs that are floating point to fp16
+        // Convert each of the inputs that are floating point to the reduced precision type
         auto inputs = ins->inputs();
         std::transform(inputs.begin(), inputs.end(), inputs.begin(), [&](auto input) {
             auto input_type = input->get_shape().type();
             if(input_type != shape::float_type and input_type != shape::double_type)
                 return input;
-            return m.insert_instruction(
-                ins, make_op("convert", {{"target_type", shape::half_type}}), input);
+            return m.insert_instruction(ins, make_op("convert", {{"target_type", type}}), input);
         });
 
         // Replace inputs
@@ -52,7 +52,9 @@ static void quantize_module(module& m, const std::vector<std::string>& ins_names
     }
 }
 
-void quantize_fp16_pass::apply(module& m) const { quantize_module(m, ins_names); }
+void quantize_fp16_pass::apply(module& m) const { quantize_module(m, ins_names, shape::half_type); }
+
+void quantize_bf16_pass::apply(module& m) const { quantize_module(m, ins_names, shape::bf16_type); }
 
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
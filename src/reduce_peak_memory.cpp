@@ -0,0 +1,200 @@
+#include <migraphx/reduce_peak_memory.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/functional.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/env.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_REDUCE_PEAK_MEMORY)
+
+struct memory_order
+{
+    module* m;
+    std::string allocation_op;
+    // The position of each instruction in the original order
+    std::unordered_map<instruction_ref, std::size_t> position;
+    // The inputs and implicit dependencies of each instruction in this module
+    std::unordered_map<instruction_ref, std::vector<instruction_ref>> deps;
+    // The instructions that depend on each instruction
+    std::unordered_map<instruction_ref, std::vector<instruction_ref>> consumers;
+    // The distinct buffers that each instruction reads or writes through its dependencies
+    std::unordered_map<instruction_ref, std::vector<instruction_ref>> buffers;
+    // The number of instructions that use each buffer
+    std::unordered_map<instruction_ref, std::size_t> uses;
+
+    memory_order(module& pm, std::string alloc_op) : m(&pm), allocation_op(std::move(alloc_op))
+    {
+        auto implicit_deps = m->calc_implicit_deps();
+        for(auto ins : iterator_for(*m))
+            position[ins] = position.size();
+        for(auto ins : iterator_for(*m))
+        {
+            std::vector<instruction_ref> inputs = ins->inputs();
+            if(contains(implicit_deps, ins))
+            {
+                const auto& impl_deps = implicit_deps.at(ins);
+                inputs.insert(inputs.end(), impl_deps.begin(), impl_deps.end());
+            }
+            auto& ins_deps    = deps[ins];
+            auto& ins_buffers = buffers[ins];
+            for(auto input : inputs)
+            {
+                // Skip the instructions from a parent module
+                if(not contains(position, input) or contains(ins_deps, input))
+                    continue;
+                ins_deps.push_back(input);
+                consumers[input].push_back(ins);
+                auto buffer = instruction::get_output_alias(input);
+                if(contains(position, buffer) and not contains(ins_buffers, buffer))
+                    ins_buffers.push_back(buffer);
+            }
+            for(auto buffer : ins_buffers)
+                uses[buffer]++;
+        }
+    }
+
+    // The bytes of the buffer an instruction writes to, which is zero when it aliases another
+    // instruction or is not in the scratch memory
+    static std::size_t bytes(instruction_ref ins)
+    {
+        if(starts_with(ins->name(), "@"))
+            return 0;
+        if(instruction::get_output_alias(ins) != ins)
+            return 0;
+        return ins->get_shape().bytes();
+    }
+
+    // Allocations are scheduled just before their first use
+    bool is_lazy(instruction_ref ins) const
+    {
+        return ins->name() == allocation_op and contains(consumers, ins);
+    }
+
+    std::size_t peak_bytes(const std::vector<instruction_ref>& order) const
+    {
+        auto remaining   = uses;
+        std::size_t live = 0;
+        std::size_t peak = 0;
+        for(auto ins : order)
+        {
+            live += bytes(ins);
+            peak = std::max(peak, live);
+            for(auto buffer : buffers.at(ins))
+            {
+                if(--remaining[buffer] == 0)
+                    live -= bytes(buffer);
+            }
+        }
+        return peak;
+    }
+
+    std::vector<instruction_ref> schedule()
+    {
+        std::vector<instruction_ref> result;
+        std::unordered_set<instruction_ref> scheduled;
+        std::unordered_map<instruction_ref, std::size_t> waiting;
+        std::vector<instruction_ref> ready;
+        auto remaining = uses;
+
+        auto unscheduled_lazy_deps = [&](instruction_ref ins) {
+            std::vector<instruction_ref> lazy_deps;
+            std::copy_if(deps[ins].begin(),
+                         deps[ins].end(),
+                         std::back_inserter(lazy_deps),
+                         [&](auto input) {
+                             return is_lazy(input) and not contains(scheduled, input);
+                         });
+            return lazy_deps;
+        };
+        // The change in the live bytes from scheduling an instruction next
+        auto cost = [&](instruction_ref ins) {
+            std::ptrdiff_t added = bytes(ins);
+            for(auto input : unscheduled_lazy_deps(ins))
+                added += bytes(input);
+            std::ptrdiff_t freed = 0;
+            for(auto buffer : buffers[ins])
+            {
+                if(remaining[buffer] == 1)
+                    freed += bytes(buffer);
+            }
+            return added - freed;
+        };
+        auto add = [&](instruction_ref ins) {
+            result.push_back(ins);
+            scheduled.insert(ins);
+            for(auto buffer : buffers[ins])
+                remaining[buffer]--;
+            if(is_lazy(ins))
+                return;
+            for(auto output : consumers[ins])
+            {
+                if(--waiting[output] == 0)
+                    ready.push_back(output);
+            }
+        };
+
+        for(auto ins : iterator_for(*m))
+        {
+            // Dependencies on allocations are satisfied when the consumer is scheduled
+            waiting[ins] = std::count_if(deps[ins].begin(), deps[ins].end(), [&](auto input) {
+                return not is_lazy(input);
+            });
+            if(waiting[ins] == 0 and not is_lazy(ins))
+                ready.push_back(ins);
+        }
+        while(not ready.empty())
+        {
+            auto best = std::min_element(ready.begin(), ready.end(), [&](auto x, auto y) {
+                // The return is kept last
+                if(x->name() == "@return" or y->name() == "@return")
+                    return y->name() == "@return" and x->name() != "@return";
+                return std::make_pair(cost(x), position[x]) < std::make_pair(cost(y), position[y]);
+            });
+            auto ins = *best;
+            ready.erase(best);
+            auto lazy_deps = unscheduled_lazy_deps(ins);
+            std::sort(lazy_deps.begin(), lazy_deps.end(), by(std::less<>{}, [&](auto x) {
+                          return position[x];
+                      }));
+            for(auto input : lazy_deps)
+                add(input);
+            add(ins);
+        }
+        return result;
+    }
+};
+
+void reduce_peak_memory::apply(module& m) const
+{
+    if(not enable)
+        return;
+    memory_order mo{m, allocation_op};
+    std::vector<instruction_ref> original;
+    for(auto ins : iterator_for(m))
+        original.push_back(ins);
+    auto order = mo.schedule();
+    if(order.size() != original.size())
+        MIGRAPHX_THROW("REDUCE_PEAK_MEMORY: Not every instruction was scheduled");
+    auto before = mo.peak_bytes(original);
+    auto after  = mo.peak_bytes(order);
+    if(enabled(MIGRAPHX_TRACE_REDUCE_PEAK_MEMORY{}))
+        std::cout << "Reduce peak memory: " << before << " bytes before, " << after
+                  << " bytes after" << std::endl;
+    if(after >= before)
+        return;
+    for(auto ins : order)
+        m.move_instruction(ins, m.end());
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -5,6 +5,7 @@
 #include <migraphx/iterator.hpp>
 #include <migraphx/dfor.hpp>
 #include <migraphx/par_for.hpp>
+#include <migraphx/thread_pool.hpp>
 #include <migraphx/functional.hpp>
 #include <migraphx/ranges.hpp>
 #include <migraphx/dom_info.hpp>
@@ -116,7 +117,7 @@ struct stream_info
         }
     };
 
-    std::size_t assign_streams(module& p, std::size_t n)
+    std::size_t assign_streams(module& p, std::size_t n, bool reorder)
     {
         assert(n > 0);
         partition critical;
@@ -151,7 +152,8 @@ struct stream_info
                 }
             }
             // Sort instructions
-            p.move_instruction(ins, p.end());
+            if(reorder)
+                p.move_instruction(ins, p.end());
         })(std::prev(p.end()), critical);
 
         // Set the critical partition to stream 0
@@ -429,8 +431,7 @@ struct stream_info
         for(auto ins : iterator_for(p))
             ins2index[ins] = index_total++;
 
-        std::vector<conflict_table_type> thread_conflict_tables(
-            std::thread::hardware_concurrency());
+        std::vector<conflict_table_type> thread_conflict_tables(thread_pool::global().size());
         std::vector<instruction_ref> index_to_ins;
         index_to_ins.reserve(concur_ins.size());
         std::transform(concur_ins.begin(),
@@ -516,8 +517,9 @@ void schedule::apply(module& p) const
     si.calc_implicit_deps(p);
     auto last = std::prev(p.end());
     si.accumulate_weights(last, model);
-    auto nstreams = si.assign_streams(p, model.concurrency());
-    si.sort(p, model.concurrency());
+    auto nstreams = si.assign_streams(p, model.concurrency(), not keep_order);
+    if(not keep_order)
+        si.sort(p, model.concurrency());
 
     if(enabled(MIGRAPHX_TRACE_COMPILE{}) or enabled(MIGRAPHX_TRACE_SCHEDULE{}))
     {
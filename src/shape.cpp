@@ -188,6 +188,12 @@ std::size_t shape::index(const std::vector<std::size_t>& l) const
     assert(this->lens().size() == this->strides().size());
     return std::inner_product(l.begin(), l.end(), this->strides().begin(), std::size_t{0});
 }
+std::size_t shape::index(const multi_index& l) const
+{
+    assert(l.size() <= this->lens().size());
+    assert(this->lens().size() == this->strides().size());
+    return std::inner_product(l.begin(), l.end(), this->strides().begin(), std::size_t{0});
+}
 std::size_t shape::index(std::size_t i) const
 {
     assert(this->lens().size() == this->strides().size());
@@ -235,6 +241,16 @@ void shape::multi_copy(std::size_t i, std::size_t* start, const std::size_t* end
                    });
 }
 
+multi_index::multi_index(const shape& s, std::size_t i) : multi_index(s.lens().size())
+{
+    const auto& lens = s.lens();
+    for(std::size_t k = m_size; k > 0; k--)
+    {
+        data()[k - 1] = i % lens[k - 1];
+        i /= lens[k - 1];
+    }
+}
+
 bool shape::packed() const
 {
     return this->sub_shapes().empty() and this->elements() == this->element_space();
@@ -0,0 +1,202 @@
+#include <migraphx/cpu/assign_layouts.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/dnnl.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/env.hpp>
+#include <unordered_map>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_DNNL_LAYOUTS);
+
+// The binary and sum post ops read memory in the standard layout
+static bool has_memory_post_ops(const value& v)
+{
+    return std::any_of(v.at("post_ops").begin(), v.at("post_ops").end(), [](const value& po) {
+        auto algo = po.at("algo").to<std::string>();
+        return algo == "sum" or contains(algo, "binary");
+    });
+}
+
+struct layout_assignment
+{
+    module* m    = nullptr;
+    context* ctx = nullptr;
+    // The layout of the output of each instruction, an empty string is the standard layout
+    std::unordered_map<instruction_ref, std::string> layouts = {};
+    std::unordered_map<instruction_ref, std::unordered_map<std::string, instruction_ref>> reorders =
+        {};
+
+    std::string get_layout(instruction_ref ins) const
+    {
+        auto it = layouts.find(ins);
+        if(it == layouts.end())
+            return "";
+        return it->second;
+    }
+
+    // The result of the module is read by the caller, and the output parameters are buffers owned
+    // by the caller, so they must be written in the standard layout
+    bool is_output(instruction_ref ins) const
+    {
+        if(ins == std::prev(m->end()))
+            return true;
+        if(instruction::get_output_alias(ins)->name() == "@param")
+            return true;
+        return std::any_of(ins->outputs().begin(), ins->outputs().end(), [](auto output) {
+            return output->name() == "@return";
+        });
+    }
+
+    instruction_ref allocate(instruction_ref pos, const shape& s, const std::string& layout)
+    {
+        return m->insert_instruction(
+            pos, make_op("cpu::allocate", {{"shape", to_value(to_dnnl_layout_shape(s, layout))}}));
+    }
+
+    // Reorder the input into the layout before the instruction at pos, which is shared with the
+    // other instructions that need the same layout
+    instruction_ref reorder(instruction_ref pos, instruction_ref input, const std::string& layout)
+    {
+        auto from = get_layout(input);
+        if(from == layout)
+            return input;
+        auto& input_reorders = reorders[input];
+        if(contains(input_reorders, layout))
+            return input_reorders.at(layout);
+        shape s{input->get_shape().type(), input->get_shape().lens()};
+        auto alloc = allocate(pos, s, layout);
+        auto op    = make_op("dnnl::reorder",
+                             {{"layouts", to_value(std::vector<std::string>{from})},
+                              {"output_layout", layout}});
+        auto r     = m->insert_instruction(pos, op, input, alloc);
+
+        layouts[r]             = layout;
+        input_reorders[layout] = r;
+        return r;
+    }
+
+    void replace(instruction_ref ins,
+                 value v,
+                 const std::vector<std::string>& input_layouts,
+                 const std::string& output_layout)
+    {
+        assert(output_layout.empty() or not is_output(ins));
+        auto inputs = ins->inputs();
+        for(std::size_t i = 0; i < inputs.size() - 1; i++)
+        {
+            auto layout = i < input_layouts.size() ? input_layouts[i] : "";
+            inputs[i]   = reorder(ins, inputs[i], layout);
+        }
+        if(not output_layout.empty())
+            inputs.back() = allocate(ins, ins->get_shape(), output_layout);
+        v["layouts"]       = to_value(input_layouts);
+        v["output_layout"] = output_layout;
+        m->replace_instruction(ins, make_op(ins->name(), v), inputs);
+        if(not output_layout.empty())
+            layouts[ins] = output_layout;
+    }
+
+    // The convolutions choose the layouts of the input, the output and constant weights, and the
+    // gemms only choose the layout of the constant weights
+    bool choose_layouts(instruction_ref ins)
+    {
+        bool convolution = contains({"dnnl::convolution", "dnnl::quant_convolution"}, ins->name());
+        if(not convolution and not contains({"dnnl::dot", "dnnl::quant_dot"}, ins->name()))
+            return false;
+        auto v      = ins->get_operator().to_value();
+        auto inputs = ins->inputs();
+        // The weights of grouped convolutions are reshaped, so they are kept standard
+        bool prepack_weights = inputs.at(1)->name() == "@literal" and
+                               (not convolution or v.at("group").to<int>() == 1);
+        std::vector<std::string> request(inputs.size() - 1);
+        if(convolution and inputs.front()->get_shape().standard())
+            request[0] = "any";
+        if(prepack_weights)
+            request[1] = "any";
+        // The post ops read the standard layout, so the output must be in the same layout
+        std::string output_request =
+            convolution and not has_memory_post_ops(v) and not is_output(ins) ? "any" : "";
+        if(std::all_of(request.begin(), request.end(), [](const auto& x) { return x.empty(); }) and
+           output_request.empty())
+            return false;
+        v["layouts"]       = to_value(request);
+        v["output_layout"] = output_request;
+        auto op            = make_op(ins->name(), v);
+        auto info          = compile(op, *ctx, ins->get_shape(), to_shapes(inputs));
+        if(not info.contains("layouts"))
+            return false;
+        replace(ins,
+                v,
+                info.at("layouts").to_vector<std::string>(),
+                info.at("output_layout").to<std::string>());
+        return true;
+    }
+
+    // Elementwise operators can compute in any layout, as long as all the inputs are in the same
+    // one
+    bool propagate_layout(instruction_ref ins)
+    {
+        if(not contains({"dnnl::eltwise", "dnnl::binary"}, ins->name()))
+            return false;
+        auto v = ins->get_operator().to_value();
+        if(has_memory_post_ops(v) or is_output(ins))
+            return false;
+        auto inputs = ins->inputs();
+        inputs.pop_back();
+        auto layout = get_layout(inputs.front());
+        if(layout.empty())
+            return false;
+        if(not std::all_of(inputs.begin(), inputs.end(), [&](auto input) {
+               return get_layout(input) == layout and input->get_shape() == ins->get_shape();
+           }))
+            return false;
+        replace(ins, v, std::vector<std::string>(inputs.size(), layout), layout);
+        return true;
+    }
+
+    // Every other operator reads the standard layout
+    void use_standard_layout(instruction_ref ins)
+    {
+        auto inputs  = ins->inputs();
+        bool changed = false;
+        for(auto& input : inputs)
+        {
+            if(get_layout(input).empty())
+                continue;
+            input   = reorder(ins, input, "");
+            changed = true;
+        }
+        if(changed)
+            m->replace_instruction(ins, ins->get_operator(), inputs, ins->module_inputs());
+    }
+
+    void apply()
+    {
+        for(auto ins : iterator_for(*m))
+        {
+            if(choose_layouts(ins))
+                continue;
+            if(propagate_layout(ins))
+                continue;
+            use_standard_layout(ins);
+        }
+    }
+};
+
+void assign_layouts::apply(module& m) const
+{
+    if(enabled(MIGRAPHX_DISABLE_DNNL_LAYOUTS{}))
+        return;
+    layout_assignment{&m, ctx}.apply();
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,236 @@
+#include <migraphx/config.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/check_shapes.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/register_op.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+// A batch of strided matrices, read as float
+template <class T>
+struct batched_matrix
+{
+    const T* data = nullptr;
+    std::vector<std::size_t> offsets;
+    std::size_t rows       = 0;
+    std::size_t row_stride = 0;
+    std::size_t col_stride = 0;
+
+    float operator()(std::size_t b, std::size_t i, std::size_t j) const
+    {
+        return float(data[offsets[b] + i * row_stride + j * col_stride]);
+    }
+};
+
+template <class T>
+batched_matrix<T> make_batched_matrix(const T* data, const shape& s, std::size_t batches)
+{
+    const auto& lens    = s.lens();
+    const auto& strides = s.strides();
+    auto n              = lens.size();
+    batched_matrix<T> result{
+        data, std::vector<std::size_t>(batches), lens[n - 2], strides[n - 2], strides[n - 1]};
+    if(n == 2)
+        return result;
+    shape bs{s.type(), {lens.begin(), lens.end() - 2}, {strides.begin(), strides.end() - 2}};
+    for(std::size_t b = 0; b < batches; b++)
+        result.offsets[b] = bs.index(b);
+    return result;
+}
+
+// The running maximum and sum of the exponentials of one row of scores, with the sum of the
+// values weighted by them
+struct online_softmax
+{
+    float max = -std::numeric_limits<float>::infinity();
+    float sum = 0;
+    std::vector<float> acc;
+
+    void reset(std::size_t n)
+    {
+        max = -std::numeric_limits<float>::infinity();
+        sum = 0;
+        acc.assign(n, 0.0f);
+    }
+
+    // Add the scores of a block of keys, where v holds the rows of the values for the block, and
+    // rescale what was accumulated so far when the maximum changes
+    void update(const float* scores, std::size_t cols, const float* v)
+    {
+        auto new_max = std::max(max, *std::max_element(scores, scores + cols));
+        // Every score so far is masked out
+        if(std::isinf(new_max) and new_max < 0)
+            return;
+        auto correction = std::exp(max - new_max);
+        max             = new_max;
+        sum *= correction;
+        std::transform(
+            acc.begin(), acc.end(), acc.begin(), [&](float a) { return a * correction; });
+        auto n = acc.size();
+        for(std::size_t j = 0; j < cols; j++)
+        {
+            auto p = std::exp(scores[j] - max);
+            sum += p;
+            const auto* vrow = v + j * n;
+            for(std::size_t x = 0; x < n; x++)
+                acc[x] += p * vrow[x];
+        }
+    }
+};
+
+/**
+ * Computes `softmax(q * k * scale + mask) * v` over the last two dimensions, with an optional
+ * mask. The scores are computed a tile at a time with an online softmax, so the full score matrix
+ * is never stored and the memory used is linear in the sequence length. Each tile of the queries
+ * and each block of the keys and values is first packed into contiguous rows, so the scores are a
+ * small gemm and the values are accumulated a row at a time, which the compiler can vectorize.
+ */
+struct cpu_attention : auto_register_op<cpu_attention>
+{
+    float scale = 1.0f;
+
+    // The number of query rows and key columns in a tile
+    static constexpr std::size_t row_tile = 16;
+    static constexpr std::size_t col_tile = 64;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.scale, "scale"));
+    }
+
+    std::string name() const { return "cpu::attention"; }
+
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        // Compensate for allocation
+        inputs.pop_back();
+        check_shapes{inputs, *this}.has(3, 4).same_type().same_ndims().min_ndims(2);
+        auto q     = inputs[0].lens();
+        auto k     = inputs[1].lens();
+        auto v     = inputs[2].lens();
+        auto ndims = q.size();
+        if(not std::equal(q.begin(), q.end() - 2, k.begin()) or
+           not std::equal(q.begin(), q.end() - 2, v.begin()))
+            MIGRAPHX_THROW("ATTENTION: batch dimensions must match");
+        if(q[ndims - 1] != k[ndims - 2] or k[ndims - 1] != v[ndims - 2])
+            MIGRAPHX_THROW("ATTENTION: inner dimensions do not match");
+        if(inputs.size() == 4)
+        {
+            auto scores       = q;
+            scores[ndims - 1] = k[ndims - 1];
+            if(inputs[3].lens() != scores)
+                MIGRAPHX_THROW("ATTENTION: mask must have the shape of the scores");
+        }
+        auto lens   = q;
+        lens.back() = v.back();
+        return {inputs[0].type(), lens};
+    }
+
+    // Copy the block of the matrix starting at (i0, j0) into contiguous rows
+    template <class M>
+    static void pack_block(float* dst,
+                           const M& x,
+                           std::size_t b,
+                           std::size_t i0,
+                           std::size_t j0,
+                           std::size_t rows,
+                           std::size_t cols)
+    {
+        for(std::size_t i = 0; i < rows; i++)
+        {
+            for(std::size_t j = 0; j < cols; j++)
+                dst[i * cols + j] = x(b, i0 + i, j0 + j);
+        }
+    }
+
+    argument
+    // cppcheck-suppress constParameter
+    compute(context& ctx, const shape& output_shape, const std::vector<argument>& args) const
+    {
+        auto lens      = args[0].get_shape().lens();
+        std::size_t m  = lens[lens.size() - 2];
+        std::size_t d  = lens.back();
+        std::size_t n  = args[1].get_shape().lens().back();
+        std::size_t dv = output_shape.lens().back();
+        std::size_t bs = output_shape.elements() / (m * dv);
+        auto row_tiles = (m + row_tile - 1) / row_tile;
+        visit_all(args)([&](auto xs) {
+            using type = typename decltype(xs)::value_type::value_type;
+            std::vector<batched_matrix<type>> inputs;
+            std::transform(xs.begin(), xs.end() - 1, std::back_inserter(inputs), [&](auto x) {
+                return make_batched_matrix(x.data(), x.get_shape(), bs);
+            });
+            const auto* mask = inputs.size() == 4 ? &inputs[3] : nullptr;
+            auto* output     = xs.back().data();
+            ctx.bulk_execute(bs * row_tiles, 1, [&](auto start, auto end) {
+                std::vector<float> qt(row_tile * d);
+                std::vector<float> kt(col_tile * d);
+                std::vector<float> vt(col_tile * dv);
+                std::vector<float> scores(col_tile);
+                std::vector<online_softmax> rows(row_tile);
+                for(auto t = start; t < end; t++)
+                {
+                    auto b     = t / row_tiles;
+                    auto i0    = (t % row_tiles) * row_tile;
+                    auto nrows = std::min(row_tile, m - i0);
+                    for(auto& row : rows)
+                        row.reset(dv);
+                    pack_block(qt.data(), inputs[0], b, i0, 0, nrows, d);
+                    std::transform(
+                        qt.begin(), qt.end(), qt.begin(), [&](float x) { return x * scale; });
+                    // The rows of the tile share each block of keys and values while it is in
+                    // the cache
+                    for(std::size_t j0 = 0; j0 < n; j0 += col_tile)
+                    {
+                        auto cols = std::min(col_tile, n - j0);
+                        pack_block(kt.data(), inputs[1], b, 0, j0, d, cols);
+                        pack_block(vt.data(), inputs[2], b, j0, 0, cols, dv);
+                        for(std::size_t i = 0; i < nrows; i++)
+                        {
+                            // Accumulate a row of the keys at a time, so the inner loop is over
+                            // contiguous scores
+                            std::fill(scores.begin(), scores.begin() + cols, 0.0f);
+                            for(std::size_t x = 0; x < d; x++)
+                            {
+                                auto qx          = qt[i * d + x];
+                                const auto* krow = kt.data() + x * cols;
+                                for(std::size_t j = 0; j < cols; j++)
+                                    scores[j] += qx * krow[j];
+                            }
+                            if(mask != nullptr)
+                            {
+                                for(std::size_t j = 0; j < cols; j++)
+                                    scores[j] += (*mask)(b, i0 + i, j0 + j);
+                            }
+                            rows[i].update(scores.data(), cols, vt.data());
+                        }
+                    }
+                    for(std::size_t i = 0; i < nrows; i++)
+                    {
+                        auto* orow = output + (b * m + i0 + i) * dv;
+                        std::transform(rows[i].acc.begin(),
+                                       rows[i].acc.end(),
+                                       orow,
+                                       [&](float a) { return type(a / rows[i].sum); });
+                    }
+                }
+            });
+        });
+        return args.back();
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,341 @@
+#include <migraphx/cpu/compile_pointwise.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/host_isa.hpp>
+#include <migraphx/compile_src.hpp>
+#include <migraphx/cpp_generator.hpp>
+#include <migraphx/dynamic_loader.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/reduce_dims.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/value.hpp>
+#include <functional>
+#include <sstream>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+// The kernel processes the elements [start, end) of the output. The lens and strides of the
+// tensors are known when compiling, so the outer index is computed with constant divisions and the
+// inner loop over the last dimension has constant strides, which lets the compiler vectorize it.
+static const char* const pointwise_kernel = R"__migraphx__(
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace migraphx {
+
+#ifdef __FLT16_MAX__
+using half = _Float16;
+#endif
+
+// The upper 16 bits of a float
+struct bf16
+{
+    std::uint16_t data;
+
+    bf16() = default;
+    bf16(float x) { *this = x; }
+
+    operator float() const
+    {
+        std::uint32_t bits = std::uint32_t(data) << 16u;
+        float result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    bf16& operator=(float x)
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        if(x != x)
+            data = (bits >> 16u) | 0x40u;
+        else
+            data = (bits + 0x7fffu + ((bits >> 16u) & 1u)) >> 16u;
+        return *this;
+    }
+};
+
+using std::acos;
+using std::acosh;
+using std::asin;
+using std::asinh;
+using std::atan;
+using std::atanh;
+using std::ceil;
+using std::cos;
+using std::cosh;
+using std::erf;
+using std::exp;
+using std::floor;
+using std::isnan;
+using std::log;
+using std::pow;
+using std::round;
+using std::sin;
+using std::sinh;
+using std::sqrt;
+using std::tan;
+using std::tanh;
+
+template <class T>
+T abs(T x)
+{
+    return x < 0 ? -x : x;
+}
+
+template <class T>
+T rsqrt(T x)
+{
+    return T(1) / std::sqrt(x);
+}
+
+template <class T, class U>
+auto max(T x, U y)
+{
+    return x > y ? x : y;
+}
+
+template <class T, class U>
+auto min(T x, U y)
+{
+    return x < y ? x : y;
+}
+
+template <class T, class U>
+T convert(U x)
+{
+    return static_cast<T>(x);
+}
+
+${preamble}
+
+extern "C" void kernel(std::size_t start, std::size_t end, void* const* args)
+{
+${params}
+    const std::size_t inner = ${inner};
+    while(start < end)
+    {
+        std::size_t i    = start / inner;
+        std::size_t j    = start % inner;
+        std::size_t last = std::min(inner, j + end - start);
+${offsets}
+        for(std::size_t k = j; k < last; k++)
+            ${output} = ${function}(${args});
+        start += last - j;
+    }
+}
+
+} // namespace migraphx
+
+)__migraphx__";
+
+static std::vector<char> compile_kernel(const std::string& src)
+{
+    src_compiler compiler;
+    // Math errno is disabled so the math functions can be vectorized
+    compiler.flags  = "-std=c++17 -O3 -march=native -fno-math-errno -fPIC -shared";
+    compiler.output = "libpointwise.so";
+    src_file f;
+    f.path    = "pointwise.cpp";
+    f.content = std::make_pair(src.data(), src.data() + src.size());
+    return compiler.compile({f});
+}
+
+struct pointwise_kernel_op
+{
+    value::binary image;
+    std::vector<shape> expected_inputs;
+    // The image is compiled for the host it was built on, so the source is kept to rebuild it when
+    // the program is loaded on a host with a different instruction set
+    std::string isa;
+    std::string src;
+    std::function<void(std::size_t, std::size_t, void* const*)> kernel = nullptr;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.image, "image"),
+                    f(self.expected_inputs, "expected_inputs"),
+                    f(self.isa, "isa"),
+                    f(self.src, "src"));
+    }
+
+    std::string name() const { return "cpu::pointwise"; }
+
+    // Each element of the output is computed from the elements at the same index
+    value attributes() const { return {{"inplace", true}}; }
+
+    shape compute_shape(const std::vector<shape>& inputs) const
+    {
+        // The strides are compiled into the kernel
+        if(inputs != expected_inputs)
+            MIGRAPHX_THROW("Input shapes have changed: [" + to_string_range(expected_inputs) +
+                           "] -> [" + to_string_range(inputs) + "]");
+        return inputs.back();
+    }
+
+    argument
+    // cppcheck-suppress constParameter
+    compute(context& ctx, const shape&, const std::vector<argument>& args) const
+    {
+        assert(kernel != nullptr);
+        std::vector<void*> kargs(args.size());
+        std::transform(
+            args.begin(), args.end(), kargs.begin(), [](const argument& a) { return a.data(); });
+        ctx.bulk_execute(args.back().get_shape().elements(), 1024, [&](auto start, auto end) {
+            kernel(start, end, kargs.data());
+        });
+        return args.back();
+    }
+
+    void finalize(context&, const shape&, const std::vector<shape>&)
+    {
+        assert(not image.empty());
+        if(isa != host_isa())
+        {
+            if(src.empty())
+                MIGRAPHX_THROW("Pointwise kernel was compiled for a different cpu: " + isa);
+            auto rebuilt = compile_kernel(src);
+            image        = value::binary{rebuilt.data(), rebuilt.size()};
+            isa          = host_isa();
+        }
+        kernel = dynamic_loader{reinterpret_cast<const char*>(image.data()), image.size()}
+                     .get_function<void(std::size_t, std::size_t, void* const*)>("kernel");
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const pointwise_kernel_op& op)
+    {
+        os << op.name() << "[image=" << op.image.size() << "]";
+        return os;
+    }
+};
+MIGRAPHX_REGISTER_OP(pointwise_kernel_op);
+
+// Half and bf16 are only used to store the tensors, the kernels compute them in float
+static bool is_storage_type(const shape& s)
+{
+    return s.type() == shape::half_type or s.type() == shape::bf16_type;
+}
+
+static std::string compute_type(const shape& s)
+{
+    if(is_storage_type(s))
+        return "float";
+    return shape::cpp_type(s.type());
+}
+
+static std::string generate_index(const std::string& offset, std::size_t stride)
+{
+    if(stride == 0)
+        return offset;
+    if(stride == 1)
+        return offset + " + k";
+    return offset + " + k * " + std::to_string(stride);
+}
+
+std::string generate_pointwise(const std::vector<shape>& inputs, const module& m)
+{
+    assert(inputs.size() > 1);
+    auto shapes = reduce_dims(inputs);
+    if(shapes.empty())
+        shapes = inputs;
+    const auto& lens = shapes.back().lens();
+    auto ndim        = lens.size();
+    auto nparams     = shapes.size() - 1;
+
+    std::stringstream params;
+    std::stringstream offsets;
+    std::vector<std::string> args;
+    for(std::size_t n = 0; n < shapes.size(); n++)
+    {
+        auto p      = "p" + std::to_string(n);
+        auto offset = p + "_offset";
+        auto type   = shape::cpp_type(shapes[n].type());
+        if(n < nparams)
+            type = "const " + type;
+        params << "    auto* " << p << " = static_cast<" << type << "*>(args[" << n << "]);\n";
+        offsets << "        std::size_t " << offset << " = 0;\n";
+        auto arg = p + "[" + generate_index(offset, shapes[n].strides().back()) + "]";
+        if(n < nparams and is_storage_type(shapes[n]))
+            arg = "float(" + arg + ")";
+        args.push_back(arg);
+    }
+    // Compute the offsets of the outer dimensions from the row index
+    for(std::size_t d = ndim - 1; d > 0; d--)
+    {
+        auto len = std::to_string(lens[d - 1]);
+        offsets << "        {\n";
+        if(d == 1)
+            offsets << "            std::size_t idx = i;\n";
+        else
+            offsets << "            std::size_t idx = i % " << len << ";\n"
+                    << "            i /= " << len << ";\n";
+        for(std::size_t n = 0; n < shapes.size(); n++)
+        {
+            auto stride = shapes[n].strides()[d - 1];
+            if(stride == 0)
+                continue;
+            offsets << "            p" << n << "_offset += idx * " << stride << ";\n";
+        }
+        offsets << "        }\n";
+    }
+
+    cpp_generator g;
+    // Add explicit conversions
+    g.fresult([](const shape& s) { return "migraphx::convert<" + compute_type(s) + ">"; });
+    // Name the function after the kernel, so identical modules generate the same source
+    auto name =
+        g.create_function(g.generate_module(m).set_name("pointwise").set_generic_types(m));
+    auto output = args.back();
+    args.pop_back();
+    return interpolate_string(pointwise_kernel,
+                              {{"preamble", g.str()},
+                               {"params", params.str()},
+                               {"inner", std::to_string(lens.back())},
+                               {"offsets", offsets.str()},
+                               {"output", output},
+                               {"function", name},
+                               {"args", join_strings(args, ", ")}});
+}
+
+operation compile_pointwise(const std::string& src, const std::vector<shape>& inputs)
+{
+    pointwise_kernel_op op;
+    auto image         = compile_kernel(src);
+    op.image           = value::binary{image.data(), image.size()};
+    op.expected_inputs = inputs;
+    op.isa             = host_isa();
+    op.src             = src;
+    return op;
+}
+
+bool pointwise_supports_half()
+{
+    // The kernels store half as _Float16, which is not available with every compiler
+    static const bool result = [] {
+        try
+        {
+            compile_kernel("#ifndef __FLT16_MAX__\n#error \"_Float16 is not supported\"\n#endif\n");
+            return true;
+        }
+        catch(const std::exception&)
+        {
+            return false;
+        }
+    }();
+    return result;
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -26,7 +26,10 @@ namespace cpu {
 
 dnnl_context& get_dnnl_context()
 {
-    static dnnl_context ctx{}; // NOLINT
+    // A dnnl stream must not be shared by threads, so each stream of a scheduled program gets its
+    // own, all of them on the same engine
+    static dnnl::engine engine{dnnl::engine::kind::cpu, 0}; // NOLINT
+    thread_local dnnl_context ctx{engine};                  // NOLINT
     return ctx;
 }
 
@@ -41,6 +44,7 @@ dnnl::memory::data_type to_dnnl_memory_data_type(shape::type_t t)
     switch(t)
     {
     case st::half_type: return dt::f16;
+    case st::bf16_type: return dt::bf16;
     case st::float_type: return dt::f32;
     case st::int32_type: return dt::s32;
     case st::int8_type: return dt::s8;
@@ -52,6 +56,27 @@ dnnl::memory::data_type to_dnnl_memory_data_type(shape::type_t t)
 #pragma clang diagnostic pop
 #endif
 
+bool dnnl_supports_type(shape::type_t t)
+{
+    // The int8 gemms accumulate into int32
+    auto output_type = t;
+    if(t == shape::int8_type or t == shape::uint8_type)
+        output_type = shape::int32_type;
+    try
+    {
+        auto a = to_dnnl_memory_desc(shape{t, {8, 8}});
+        auto b = to_dnnl_memory_desc(shape{t == shape::uint8_type ? shape::int8_type : t, {8, 8}});
+        auto c = to_dnnl_memory_desc(shape{output_type, {8, 8}});
+        dnnl::matmul::desc desc{a, b, c};
+        dnnl::matmul::primitive_desc pd{desc, get_dnnl_context().engine};
+        return true;
+    }
+    catch(const dnnl::error&)
+    {
+        return false;
+    }
+}
+
 dnnl::memory::format_tag to_dnnl_memory_format_tag(std::size_t n)
 {
     switch(n)
@@ -71,6 +96,88 @@ dnnl::memory::desc to_dnnl_memory_desc(const shape& s)
     return {to_dnnl_dims(s.lens()), to_dnnl_memory_data_type(s.type()), to_dnnl_dims(s.strides())};
 }
 
+// clang-format off
+#define MIGRAPHX_VISIT_DNNL_LAYOUT(m) \
+        m(nCw16c) \
+        m(nCw8c) \
+        m(nChw16c) \
+        m(nChw8c) \
+        m(nChw4c) \
+        m(nCdhw16c) \
+        m(nCdhw8c) \
+        m(nwc) \
+        m(nhwc) \
+        m(ndhwc) \
+        m(OIw16i16o) \
+        m(OIw8i8o) \
+        m(Owi16o) \
+        m(Owi8o) \
+        m(OIhw16i16o) \
+        m(OIhw8i8o) \
+        m(OIhw16o16i) \
+        m(OIhw4i16o4i) \
+        m(Ohwi16o) \
+        m(Ohwi8o) \
+        m(OIdhw16i16o) \
+        m(OIdhw8i8o) \
+        m(Odhwi16o) \
+        m(Odhwi8o) \
+        m(ba) \
+        m(acb) \
+        m(BA16a64b) \
+        m(BA16a64b4a) \
+        m(aCB16b64c) \
+        m(aCB16b64c4b)
+// clang-format on
+
+const std::unordered_map<std::string, dnnl::memory::format_tag>& dnnl_layout_map()
+{
+    static const std::unordered_map<std::string, dnnl::memory::format_tag> m = {
+#define MIGRAPHX_DNNL_LAYOUT_GENERATE_VISITOR(x) {#x, dnnl::memory::format_tag::x},
+        MIGRAPHX_VISIT_DNNL_LAYOUT(MIGRAPHX_DNNL_LAYOUT_GENERATE_VISITOR)
+#undef MIGRAPHX_DNNL_LAYOUT_GENERATE_VISITOR
+        {"any", dnnl::memory::format_tag::any}};
+    return m;
+}
+
+dnnl::memory::desc to_dnnl_memory_desc(const shape& s, const std::string& layout)
+{
+    if(layout.empty())
+        return to_dnnl_memory_desc(s);
+    if(dnnl_layout_map().count(layout) == 0)
+        MIGRAPHX_THROW("Missing dnnl layout: " + layout);
+    return {to_dnnl_dims(s.lens()),
+            to_dnnl_memory_data_type(s.type()),
+            dnnl_layout_map().at(layout)};
+}
+
+std::string to_dnnl_layout(const dnnl::memory::desc& desc, const shape& s)
+{
+    if(desc == to_dnnl_memory_desc(s))
+        return "";
+    for(auto&& p : dnnl_layout_map())
+    {
+        if(p.first == "any")
+            continue;
+        try
+        {
+            if(desc == to_dnnl_memory_desc(s, p.first))
+                return p.first;
+        }
+        catch(const dnnl::error&)
+        {
+            // The format tag has a different number of dimensions
+        }
+    }
+    return "";
+}
+
+shape to_dnnl_layout_shape(const shape& s, const std::string& layout)
+{
+    auto bytes = to_dnnl_memory_desc(s, layout).get_size();
+    return {s.type(), {(bytes + s.type_size() - 1) / s.type_size()}};
+}
+
 dnnl::memory to_dnnl_memory(const dnnl::memory::desc& desc, const argument& a)
 {
     return {desc, get_dnnl_context().engine, a.data()};
@@ -21,6 +21,14 @@ struct dnnl_eltwise : dnnl_op<dnnl_eltwise, dnnl::eltwise_forward>
 
     std::string name() const { return "dnnl::eltwise"; }
 
+    // The destination can be the source, but not the inputs of the post ops
+    value attributes() const
+    {
+        auto result       = dnnl_op::attributes();
+        result["inplace"] = this->post_ops.empty();
+        return result;
+    }
+
     shape compute_shape(std::vector<shape> inputs) const
     {
         // Compensate for allocation
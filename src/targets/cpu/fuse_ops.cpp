@@ -3,6 +3,9 @@
 #include <migraphx/operation.hpp>
 #include <migraphx/value.hpp>
 #include <migraphx/matcher.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/stringutils.hpp>
 #include <migraphx/context.hpp>
 #include <migraphx/env.hpp>
 #include <migraphx/cpu/context.hpp>
@@ -12,7 +15,7 @@ namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
-MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_DNNL_POST_OPS_WORKAROUND);
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_DNNL_POST_OPS);
 
 MIGRAPHX_PRED_MATCHER(has_post_ops, instruction_ref ins)
 {
@@ -20,71 +23,78 @@ MIGRAPHX_PRED_MATCHER(has_post_ops, instruction_ref ins)
     return v.contains("post_ops");
 }
 
-MIGRAPHX_PRED_MATCHER(without_post_ops, instruction_ref ins)
+static bool is_commutative(const std::string& algo)
 {
-    auto v = ins->get_operator().to_value();
-    return v.contains("post_ops") and v["post_ops"].empty();
+    return contains({"binary_add", "binary_max", "binary_min", "binary_mul"}, algo);
 }
 
-bool workaround_dnnl_broken_post_ops(const operation& op, const operation& post_op)
+// The residual of an add can be accumulated into the destination with a sum post op, when it is
+// a temporary buffer of the same shape that is not read by anything else
+static bool can_sum_into(instruction_ref residual, instruction_ref ins)
 {
-    if(contains({"dnnl::dot", "dnnl::convolution"}, op.name()))
-        return true;
-    auto pv = post_op.to_value();
-    if(not pv.at("post_ops").empty())
-        return true;
-    auto v         = op.to_value();
-    auto last_op   = v.at("post_ops").empty() ? v : v.at("post_ops").back();
-    auto algo      = last_op.contains("algo") ? last_op.at("algo").to<std::string>() : op.name();
-    auto post_algo = pv["algo"].to<std::string>();
-    if(starts_with(algo, "eltwise") and starts_with(post_algo, "eltwise"))
-        return true;
-    if(algo == post_algo)
-        return true;
-    return false;
+    if(residual->get_shape() != ins->get_shape())
+        return false;
+    if(instruction::get_output_alias(residual)->name() != "cpu::allocate")
+        return false;
+    return instruction::is_only_used_by(residual, ins);
 }
 
-operation merge_post_ops(const operation& op, const operation& post_op)
+operation merge_post_ops(const operation& op, const operation& post_op, const std::string& algo)
 {
     auto pv = post_op.to_value();
     auto v  = op.to_value();
-    v["post_ops"].push_back({{"algo", pv["algo"]},
+    v["post_ops"].push_back({{"algo", algo},
                              {"alpha", pv["alpha"].value_or(0.0f)},
                              {"beta", pv["beta"].value_or(0.0f)}});
-    auto post_ops = pv.at("post_ops");
-    for(const auto& po : post_ops)
-        v["post_ops"].push_back(po);
     return make_op(op.name(), v);
 }
 
 struct find_post_ops
 {
     context* ctx = nullptr;
-    match::any_matcher matcher() const
+    auto matcher() const
     {
-        if(enabled(MIGRAPHX_DISABLE_DNNL_POST_OPS_WORKAROUND{}))
-            return match::name("dnnl::eltwise",
-                               "dnnl::binary")(match::arg(0)(has_post_ops(), match::used_once()));
-        else
-            return match::name("dnnl::eltwise")(
-                without_post_ops(),
-                match::arg(0)(match::name("dnnl::binary")(without_post_ops(), match::used_once())));
+        auto producer = has_post_ops(match::used_once()).bind("x");
+        return match::any_of(match::name("dnnl::eltwise")(match::arg(0)(producer)),
+                             match::name("dnnl::binary")(match::any_arg(0, 1)(producer)));
     }
 
     void apply(module& m, const match::matcher_result& r) const
     {
         auto ins   = r.result;
-        auto x_ins = ins->inputs().front();
+        auto x_ins = r.instructions.at("x");
         auto x     = x_ins->get_operator();
-
-        if(workaround_dnnl_broken_post_ops(x, ins->get_operator()))
+        auto pv    = ins->get_operator().to_value();
+        // The post ops of the post op would need their arguments appended as well
+        if(not pv.at("post_ops").empty())
             return;
-
-        auto op       = merge_post_ops(x, ins->get_operator());
-        auto inputs   = x_ins->inputs();
-        inputs.back() = ins->inputs().back();
+        auto algo   = pv.at("algo").to<std::string>();
+        auto inputs = x_ins->inputs();
         if(ins->name() == "dnnl::binary")
-            inputs.insert(std::prev(inputs.end()), ins->inputs().at(1));
+        {
+            auto other = ins->inputs().at(0);
+            if(other == x_ins)
+                other = ins->inputs().at(1);
+            else if(not is_commutative(algo))
+                return;
+            if(other == x_ins)
+                return;
+            if(algo == "binary_add" and can_sum_into(other, ins))
+            {
+                algo          = "sum";
+                inputs.back() = other;
+            }
+            else
+            {
+                inputs.back() = ins->inputs().back();
+                inputs.insert(std::prev(inputs.end()), other);
+            }
+        }
+        else
+        {
+            inputs.back() = ins->inputs().back();
+        }
+        auto op           = merge_post_ops(x, ins->get_operator(), algo);
         auto input_shapes = to_shapes(inputs);
         auto new_shape    = try_compute_shape(op, input_shapes);
         if(new_shape.empty() or new_shape.front() != ins->get_shape())
@@ -98,6 +108,8 @@ struct find_post_ops
 
 void fuse_ops::apply(module& m) const
 {
+    if(enabled(MIGRAPHX_DISABLE_DNNL_POST_OPS{}))
+        return;
     for(std::size_t i = 0; i < 4; i++)
     {
         match::find_matches(m, find_post_ops{ctx});
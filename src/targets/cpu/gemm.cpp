@@ -11,7 +11,8 @@ namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
-struct dnnl_gemm : dnnl_extend_op<dnnl_gemm, dnnl::matmul, op::dot>
+template <class Derived, class Op>
+struct dnnl_gemm_base : dnnl_extend_op<Derived, dnnl::matmul, Op>
 {
     std::vector<int> arg_map(int) const
     {
@@ -30,6 +31,15 @@ struct dnnl_gemm : dnnl_extend_op<dnnl_gemm, dnnl::matmul, op::dot>
     }
 };
 
+struct dnnl_gemm : dnnl_gemm_base<dnnl_gemm, op::dot>
+{
+};
+
+// The int8 gemm accumulates into int32 natively in dnnl
+struct dnnl_quant_gemm : dnnl_gemm_base<dnnl_quant_gemm, op::quant_dot>
+{
+};
+
 } // namespace cpu
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
@@ -0,0 +1,46 @@
+#include <migraphx/cpu/host_isa.hpp>
+#include <migraphx/stringutils.hpp>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+static std::string compute_host_isa()
+{
+    std::vector<std::string> features;
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+// The builtin only accepts a string literal
+#define MIGRAPHX_CPU_FEATURE(x)   \
+    if(__builtin_cpu_supports(x)) \
+        features.push_back(x);
+    MIGRAPHX_CPU_FEATURE("popcnt")
+    MIGRAPHX_CPU_FEATURE("sse4.2")
+    MIGRAPHX_CPU_FEATURE("avx")
+    MIGRAPHX_CPU_FEATURE("avx2")
+    MIGRAPHX_CPU_FEATURE("fma")
+    MIGRAPHX_CPU_FEATURE("bmi")
+    MIGRAPHX_CPU_FEATURE("bmi2")
+    MIGRAPHX_CPU_FEATURE("avx512f")
+    MIGRAPHX_CPU_FEATURE("avx512dq")
+    MIGRAPHX_CPU_FEATURE("avx512cd")
+    MIGRAPHX_CPU_FEATURE("avx512bw")
+    MIGRAPHX_CPU_FEATURE("avx512vl")
+    MIGRAPHX_CPU_FEATURE("avx512ifma")
+    MIGRAPHX_CPU_FEATURE("avx512vbmi")
+    MIGRAPHX_CPU_FEATURE("avx512vnni")
+#undef MIGRAPHX_CPU_FEATURE
+#endif
+    return join_strings(features, ",");
+}
+
+std::string host_isa()
+{
+    static const std::string result = compute_host_isa();
+    return result;
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
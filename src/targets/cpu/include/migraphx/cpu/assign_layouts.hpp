@@ -0,0 +1,32 @@
+#ifndef MIGRAPHX_GUARD_CPU_ASSIGN_LAYOUTS_HPP
+#define MIGRAPHX_GUARD_CPU_ASSIGN_LAYOUTS_HPP
+
+#include <migraphx/config.hpp>
+#include <string>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct module;
+
+namespace cpu {
+
+struct context;
+
+/**
+ * Let the dnnl convolutions and gemms choose the layouts of their arguments, and keep the blocked
+ * layouts between the dnnl operators that can read them. Reorders are only inserted where another
+ * operator needs the standard layout, and the reorders of the constant weights are folded by
+ * write_literals.
+ */
+struct assign_layouts
+{
+    context* ctx = nullptr;
+    std::string name() const { return "cpu::assign_layouts"; }
+    void apply(module& m) const;
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+#endif // MIGRAPHX_GUARD_CPU_ASSIGN_LAYOUTS_HPP
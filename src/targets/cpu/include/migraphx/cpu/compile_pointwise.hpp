@@ -0,0 +1,29 @@
+#ifndef MIGRAPHX_GUARD_AMDMIGRAPHX_CPU_COMPILE_POINTWISE_HPP
+#define MIGRAPHX_GUARD_AMDMIGRAPHX_CPU_COMPILE_POINTWISE_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/operation.hpp>
+#include <migraphx/shape.hpp>
+#include <string>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+struct module;
+namespace cpu {
+
+// Generate the source of a kernel that applies the pointwise module `m` to the `inputs`, where the
+// last input is the output
+std::string generate_pointwise(const std::vector<shape>& inputs, const module& m);
+
+// Compile the source from generate_pointwise into a `cpu::pointwise` operator
+operation compile_pointwise(const std::string& src, const std::vector<shape>& inputs);
+
+// Check if the compiler can build the kernels for half tensors
+bool pointwise_supports_half();
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -3,8 +3,12 @@
 
 #include <migraphx/config.hpp>
 #include <migraphx/cpu/dnnl.hpp>
+#include <migraphx/cpu/host_isa.hpp>
 #include <migraphx/cpu/parallel.hpp>
+#include <migraphx/cpu/stream.hpp>
 #include <migraphx/par_for.hpp>
+#include <migraphx/value.hpp>
+#include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -12,7 +16,11 @@ namespace cpu {
 
 struct context
 {
-    void finish() const {}
+    void finish() const
+    {
+        for(auto&& s : streams)
+            s.sync();
+    }
 
     template <class F>
     void bulk_execute(std::size_t n, std::size_t min_grain, F f)
@@ -25,6 +33,83 @@ struct context
     {
         this->bulk_execute(n, 256, f);
     }
+
+    // Stream 0 is the thread evaluating the program, the other streams run on their own threads
+    void set_stream(std::size_t n)
+    {
+        if(n > streams.size())
+            streams.resize(n);
+        current_stream = n;
+    }
+
+    std::size_t get_stream_id() const { return current_stream; }
+
+    /// Run `f` on the current stream
+    template <class F>
+    void launch(F f) const
+    {
+        if(current_stream == 0)
+            f();
+        else
+            get_stream().launch(f);
+    }
+
+    /// Wait for the work launched on the current stream
+    void sync_stream() const
+    {
+        if(current_stream > 0)
+            get_stream().sync();
+    }
+
+    void create_events(std::size_t num_of_events)
+    {
+        if(num_of_events >= events.size())
+            events.resize(num_of_events + 1);
+    }
+
+    void record_event(std::size_t i)
+    {
+        create_events(i);
+        // A new event each time, so a wait only sees the record that came before it
+        events[i] = event{};
+        if(current_stream == 0)
+            events[i].signal();
+        else
+            get_stream().record(events[i]);
+    }
+
+    void wait_event(std::size_t i) const
+    {
+        if(i >= events.size())
+            return;
+        if(current_stream == 0)
+            events[i].wait();
+        else
+            get_stream().wait(events[i]);
+    }
+
+    // The instruction set the program was compiled for
+    std::string isa = host_isa();
+
+    value to_value() const
+    {
+        value result;
+        result["isa"] = isa;
+        return result;
+    }
+
+    void from_value(const value& v)
+    {
+        if(v.contains("isa"))
+            isa = v.at("isa").to<std::string>();
+    }
+
+    private:
+    const stream& get_stream() const { return streams.at(current_stream - 1); }
+
+    std::size_t current_stream = 0;
+    std::vector<stream> streams;
+    std::vector<event> events;
 };
 
 } // namespace cpu
@@ -32,12 +32,16 @@ struct dnnl_context
     dnnl::engine engine;
     dnnl::stream stream;
     dnnl_context() : engine(dnnl::engine::kind::cpu, 0), stream(engine) {}
+    explicit dnnl_context(const dnnl::engine& e) : engine(e), stream(engine) {}
 };
 
 dnnl_context& get_dnnl_context();
 
 dnnl::memory::data_type to_dnnl_memory_data_type(shape::type_t t);
 
+// Check if dnnl can compute gemms in the type on this cpu
+bool dnnl_supports_type(shape::type_t t);
+
 dnnl::memory::format_tag to_dnnl_memory_format_tag(std::size_t n);
 
 template <class R>
@@ -48,6 +52,17 @@ inline dnnl::memory::dims to_dnnl_dims(R&& r)
 
 dnnl::memory::desc to_dnnl_memory_desc(const shape& s);
 
+// The layout is the name of a dnnl format tag, an empty layout uses the strides of the shape, and
+// "any" lets the primitive choose the layout
+dnnl::memory::desc to_dnnl_memory_desc(const shape& s, const std::string& layout);
+
+// Name of the format tag of the memory descriptor, which is empty when the descriptor is the
+// standard layout or the format tag is unknown
+std::string to_dnnl_layout(const dnnl::memory::desc& desc, const shape& s);
+
+// Shape of the buffer to store the tensor in the layout, which can be padded
+shape to_dnnl_layout_shape(const shape& s, const std::string& layout);
+
 dnnl::memory to_dnnl_memory(const dnnl::memory::desc& desc, const argument& a);
 
 dnnl::memory to_dnnl_memory(const argument& a);
@@ -72,12 +87,17 @@ template <class Derived, class Primitive>
 struct dnnl_op : auto_register_op<Derived>
 {
     std::vector<post_op> post_ops;
+    // The layouts of the inputs and the output, which are assigned by assign_layouts
+    std::vector<std::string> layouts;
+    std::string output_layout;
     std::function<argument(context& ctx, const std::vector<argument>& args)> execute;
 
     template <class Self, class F>
     static auto reflect_base(Self& self, F f)
     {
-        return pack(f(self.post_ops, "post_ops"));
+        return pack(f(self.post_ops, "post_ops"),
+                    f(self.layouts, "layouts"),
+                    f(self.output_layout, "output_layout"));
     }
 
     template <class Self, class F>
@@ -182,6 +202,7 @@ struct dnnl_op : auto_register_op<Derived>
         }
     }
     shape adjust_shape(const shape& s, int) const { return base_adjust_shape(s); }
+    std::string get_layout(std::size_t i) const { return i < layouts.size() ? layouts[i] : ""; }
     std::vector<int> create_arg_map(std::size_t input_size) const
     {
         const auto& self     = static_cast<const Derived&>(*this);
@@ -201,12 +222,12 @@ struct dnnl_op : auto_register_op<Derived>
         const auto& self = static_cast<const Derived&>(*this);
         std::unordered_map<int, dnnl::memory::desc> result;
         result[MIGRAPHX_DNNL_PREFIX(ARG_DST)] =
-            to_dnnl_memory_desc(self.adjust_shape(output_shape, inputs.size()));
+            to_dnnl_memory_desc(self.adjust_shape(output_shape, inputs.size()), output_layout);
         auto m = create_arg_map(inputs.size());
         assert(m.size() >= inputs.size());
         for(int i = 0; i < inputs.size(); i++)
         {
-            result[m[i]] = to_dnnl_memory_desc(self.adjust_shape(inputs[i], i));
+            result[m[i]] = to_dnnl_memory_desc(self.adjust_shape(inputs[i], i), get_layout(i));
         }
         return result;
     }
@@ -216,18 +237,11 @@ struct dnnl_op : auto_register_op<Derived>
         dnnl::primitive_attr result;
         dnnl::post_ops po;
         for_each_post_op([&](auto&& op, auto arg) {
-            if(contains(op.algo, "binary_add"))
-            {
-                auto desc = m.at(arg);
-                if(desc == m.at(MIGRAPHX_DNNL_PREFIX(ARG_DST)))
-                    po.append_sum(1.0f);
-                else
-                    po.append_binary(to_dnnl_algo(op.algo), m.at(arg));
-            }
+            // The sum accumulates into the destination, which already holds the addend
+            if(op.algo == "sum")
+                po.append_sum(1.0f);
             else if(contains(op.algo, "binary"))
-            {
                 po.append_binary(to_dnnl_algo(op.algo), m.at(arg));
-            }
             else if(contains(op.algo, "eltwise"))
                 po.append_eltwise(1.0f, to_dnnl_algo(op.algo), op.alpha, op.beta);
             else
@@ -242,13 +256,16 @@ struct dnnl_op : auto_register_op<Derived>
     {
         return typename Primitive::primitive_desc(desc, attr, get_dnnl_context().engine);
     }
-    Primitive get_primitive(const std::unordered_map<int, dnnl::memory::desc>& m) const
+    auto create_primitive_desc(const std::unordered_map<int, dnnl::memory::desc>& m) const
     {
         const auto& self = static_cast<const Derived&>(*this);
         auto desc        = self.get_desc(m);
         auto attr        = MIGRAPHX_ASSERT_NO_THROW(this->get_primitive_attr(m));
-        auto pd          = self.get_primitive_desc(desc, attr);
-        return Primitive(pd);
+        return self.get_primitive_desc(desc, attr);
+    }
+    Primitive get_primitive(const std::unordered_map<int, dnnl::memory::desc>& m) const
+    {
+        return Primitive(create_primitive_desc(m));
     }
     argument compute(context& ctx, const shape&, const std::vector<argument>& args) const
     {
@@ -263,10 +280,31 @@ struct dnnl_op : auto_register_op<Derived>
     {
         // Compensate for allocation
         inputs.pop_back();
-        auto md        = to_memory_desc(output_shape, inputs);
-        auto prim      = get_primitive(md);
-        auto impl_name = impl(prim);
-        return {{"impl", impl_name}};
+        const auto& self = static_cast<const Derived&>(*this);
+        auto md          = to_memory_desc(output_shape, inputs);
+        auto pd          = create_primitive_desc(md);
+        value result     = {{"impl", impl(Primitive(pd))}};
+        if(output_layout != "any" and not contains(layouts, "any"))
+            return result;
+        // Report the layouts the primitive chose
+        auto chosen_layout = [&](int arg, const shape& s) {
+            return to_dnnl_layout(pd.query_md(dnnl::query::exec_arg_md, arg), s);
+        };
+        auto arg_lookup = create_arg_map(inputs.size());
+        std::vector<std::string> chosen(inputs.size());
+        for(int i = 0; i < inputs.size(); i++)
+        {
+            chosen[i] = get_layout(i);
+            if(chosen[i] == "any")
+                chosen[i] = chosen_layout(arg_lookup[i], self.adjust_shape(inputs[i], i));
+        }
+        result["layouts"]       = to_value(chosen);
+        result["output_layout"] = output_layout;
+        if(output_layout == "any")
+            result["output_layout"] =
+                chosen_layout(MIGRAPHX_DNNL_PREFIX(ARG_DST),
+                              self.adjust_shape(output_shape, inputs.size()));
+        return result;
     }
 
     void finalize(context&, const shape& output_shape, std::vector<shape> inputs)
@@ -278,6 +316,8 @@ struct dnnl_op : auto_register_op<Derived>
         auto md          = to_memory_desc(output_shape, inputs);
         auto prim        = get_primitive(md);
         auto arg_lookup  = create_arg_map(inputs.size());
+        // The buffer of a blocked layout can be larger than the output
+        bool reshape_output = not output_layout.empty();
 #ifndef NDEBUG
         auto prim_attr = get_primitive_attr(md);
 #endif
@@ -329,7 +369,9 @@ struct dnnl_op : auto_register_op<Derived>
                     else if(kind == dnnl::primitive::kind::sum)
                     {
                         pos.get_params_sum(i, scale);
-                        algo = dnnl::algorithm::binary_add;
+                        if(post_ops[i].algo != "sum")
+                            MIGRAPHX_THROW(mesg + "Expected sum for post op " + post_ops[i].algo);
+                        continue;
                     }
                     else
                     {
@@ -351,6 +393,8 @@ struct dnnl_op : auto_register_op<Derived>
             for(int i = 0; i < args.size() - 1; i++)
                 m[arg_lookup[i]] = to_dnnl_memory(md.at(arg_lookup[i]), args[i]);
             prim.execute(get_dnnl_context().stream, m);
+            if(reshape_output)
+                return args.back().reshape(output_shape);
             return args.back();
         };
     }
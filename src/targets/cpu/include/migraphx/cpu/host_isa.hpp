@@ -0,0 +1,19 @@
+#ifndef MIGRAPHX_GUARD_AMDMIGRAPHX_CPU_HOST_ISA_HPP
+#define MIGRAPHX_GUARD_AMDMIGRAPHX_CPU_HOST_ISA_HPP
+
+#include <migraphx/config.hpp>
+#include <string>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+/// The instruction set extensions of the host that generated code can use, as a comma separated
+/// list
+std::string host_isa();
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -7,14 +7,16 @@
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
-struct module;
+struct module_pass_manager;
 
 namespace cpu {
 
 struct lowering
 {
+    // Fuse the pointwise operators that are not lowered to dnnl and compile them into kernels
+    bool pointwise_fusion = true;
     std::string name() const { return "cpu::lowering"; }
-    void apply(module& m) const;
+    void apply(module_pass_manager& mpm) const;
 };
 
 } // namespace cpu
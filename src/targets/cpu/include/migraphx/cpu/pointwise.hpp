@@ -316,6 +316,7 @@ struct cpu_unary : reduce_dims_base, auto_register_op<cpu_unary<Op>>
         return migraphx::reflect(self.op, f);
     }
     std::string name() const { return "cpu::" + op.name(); }
+    value attributes() const { return {{"inplace", true}}; }
     shape compute_shape(const std::vector<shape>& inputs) const
     {
         check_shapes{inputs, *this}.has(2);
@@ -354,6 +355,7 @@ struct cpu_binary : reduce_dims_base, auto_register_op<cpu_binary<Op>>
         return migraphx::reflect(self.op, f);
     }
     std::string name() const { return "cpu::" + op.name(); }
+    value attributes() const { return {{"inplace", true}}; }
     shape compute_shape(const std::vector<shape>& inputs) const
     {
         check_shapes{inputs, *this}.has(3);
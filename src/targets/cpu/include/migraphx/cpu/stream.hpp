@@ -0,0 +1,53 @@
+#ifndef MIGRAPHX_GUARD_AMDMIGRAPHX_CPU_STREAM_HPP
+#define MIGRAPHX_GUARD_AMDMIGRAPHX_CPU_STREAM_HPP
+
+#include <migraphx/config.hpp>
+#include <exception>
+#include <functional>
+#include <memory>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+struct stream_impl;
+struct event_impl;
+
+/// A point in a stream that other streams can wait for
+struct event
+{
+    event();
+
+    /// Mark the event as reached, passing on the first error raised by the stream before it
+    void signal(std::exception_ptr e = nullptr) const;
+    /// Block until the event is reached and rethrow the error it was signaled with
+    void wait() const;
+
+    private:
+    std::shared_ptr<event_impl> impl;
+};
+
+/// Runs tasks one after another on a thread of its own, so the instructions scheduled on
+/// different streams run concurrently like they would on the streams of a gpu
+struct stream
+{
+    stream();
+
+    /// Queue `f` to run after every task launched before it
+    void launch(std::function<void()> f) const;
+    /// Queue a signal of `e` that happens once the tasks launched so far have finished
+    void record(const event& e) const;
+    /// Keep the tasks launched after this from starting until `e` is signaled
+    void wait(const event& e) const;
+    /// Block until every launched task has finished and rethrow the first error raised by one
+    void sync() const;
+
+    private:
+    std::shared_ptr<stream_impl> impl;
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -9,8 +9,15 @@ inline namespace MIGRAPHX_INLINE_NS {
 struct module;
 namespace cpu {
 
+struct context;
+
+/**
+ * Replace the literals with cpu::literal, and fold the reorders of the literals into the layouts
+ * the dnnl operators use.
+ */
 struct write_literals
 {
+    context* ctx = nullptr;
     std::string name() const { return "cpu::write_literals"; }
     void apply(module& m) const;
 };
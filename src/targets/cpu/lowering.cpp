@@ -1,6 +1,7 @@
 
 #include <migraphx/cpu/lowering.hpp>
 #include <migraphx/instruction.hpp>
+#include <migraphx/builtin.hpp>
 #include <migraphx/dfor.hpp>
 #include <migraphx/op/identity.hpp>
 #include <migraphx/op/batch_norm_inference.hpp>
@@ -23,17 +24,26 @@
 #include <migraphx/shape_for_each.hpp>
 #include <migraphx/iterator_for.hpp>
 #include <migraphx/par_dfor.hpp>
+#include <migraphx/par_for.hpp>
 #include <migraphx/clamp.hpp>
 #include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/compile_pointwise.hpp>
 #include <migraphx/register_op.hpp>
 #include <migraphx/make_op.hpp>
 #include <migraphx/program.hpp>
 #include <migraphx/tune_axis.hpp>
 #include <migraphx/match/layernorm.hpp>
+#include <migraphx/match/attention.hpp>
 #include <migraphx/match/gelu_erf.hpp>
 #include <migraphx/match/gelu_tanh.hpp>
 #include <migraphx/matcher.hpp>
+#include <migraphx/fuse_pointwise.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/env.hpp>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <iostream>
 
@@ -41,6 +51,8 @@ namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_ENABLE_CPU_ATTENTION)
+
 template <typename T>
 T zero(const T&)
 {
@@ -177,7 +189,7 @@ struct cpu_pad
 
         visit_all(result, args[0])([&](auto output, auto input) {
             shape_for_each(input.get_shape(), [&](const auto& idx) {
-                std::vector<std::size_t> new_idx(idx.size());
+                auto new_idx = idx;
                 std::transform(
                     idx.begin(), idx.end(), op.pads.begin(), new_idx.begin(), [](auto i, auto j) {
                         return i + j;
@@ -290,8 +302,11 @@ MIGRAPHX_REGISTER_OP(cpu_rnn_var_sl_last_output)
 struct cpu_apply
 {
     module* modl;
+    module_pass_manager* mpm = nullptr;
     std::unordered_map<std::string, std::function<instruction_ref(instruction_ref)>> apply_map{};
     std::unordered_map<instruction_ref, std::string> prog_output_names{};
+    // The operators that are lowered to dnnl operators that can be fused as post ops
+    std::unordered_set<std::string> post_op_names{};
     instruction_ref last{};
 
     void create_output_names()
@@ -332,6 +347,8 @@ struct cpu_apply
         {
             std::string op_name = pp.first;
             std::string algo    = pp.second;
+            if(contains({"dnnl::binary", "dnnl::eltwise"}, dnnl_name))
+                post_op_names.insert(op_name);
             apply_map.emplace(op_name, [=](instruction_ref ins) {
                 auto v = ins->get_operator().to_value();
                 if(not v.is_object())
@@ -358,6 +375,57 @@ struct cpu_apply
         });
     }
 
+    // Compute the attention with a kernel that never stores the full matrix of scores. It has not
+    // been shown to be faster than the two dnnl gemms it replaces, so it must be enabled.
+    auto find_attention()
+    {
+        return match::make_match_finder(match::attention(), [=](auto&, const auto& r) {
+            if(not enabled(MIGRAPHX_ENABLE_CPU_ATTENTION{}))
+                return;
+            auto ins     = r.result;
+            auto softmax = r.instructions.at("softmax");
+            auto ndims   = static_cast<int64_t>(ins->get_shape().lens().size());
+            auto axis    = softmax->get_operator().to_value()["axis"].template to<int64_t>();
+            if(axis < 0)
+                axis += ndims;
+            if(axis != ndims - 1)
+                return;
+            if(not contains({shape::float_type, shape::half_type, shape::bf16_type},
+                            ins->get_shape().type()))
+                return;
+            float scale = 1.0f;
+            if(contains(r.instructions, "scaled"))
+            {
+                auto s = r.instructions.at("scale")->eval();
+                if(s.empty() or s.get_shape().elements() != 1)
+                    return;
+                scale = s.template at<float>();
+                if(r.instructions.at("scaled")->name() == "div")
+                    scale = 1.0f / scale;
+            }
+            std::vector<instruction_ref> inputs = {
+                r.instructions.at("q"), r.instructions.at("k"), r.instructions.at("v")};
+            if(contains(r.instructions, "masked"))
+            {
+                auto masked = r.instructions.at("masked");
+                auto scores = contains(r.instructions, "scaled") ? r.instructions.at("scaled")
+                                                                 : r.instructions.at("scores");
+                auto mask   = masked->inputs().front();
+                if(mask == scores)
+                    mask = masked->inputs().back();
+                inputs.push_back(mask);
+            }
+            auto op     = make_op("cpu::attention", {{"scale", scale}});
+            auto shapes = to_shapes(inputs);
+            shapes.push_back(ins->get_shape());
+            auto new_shape = try_compute_shape(op, shapes);
+            if(new_shape.empty() or new_shape.front() != ins->get_shape())
+                return;
+            inputs.push_back(this->insert_allocation(ins, ins->get_shape()));
+            modl->replace_instruction(ins, op, inputs);
+        });
+    }
+
     void init()
     {
         create_output_names();
@@ -392,9 +460,11 @@ struct cpu_apply
         extend_op("concat", "dnnl::concat");
         extend_op("contiguous", "dnnl::reorder");
         extend_op("convolution", "dnnl::convolution");
+        extend_op("quant_convolution", "dnnl::quant_convolution");
 #ifndef MIGRAPHX_ENABLE_ZENDNN
         extend_op("deconvolution", "dnnl::deconvolution");
         extend_op("dot", "dnnl::dot");
+        extend_op("quant_dot", "dnnl::quant_dot");
 #endif
         extend_op("erf", "cpu::erf");
         extend_op("gather", "cpu::gather");
@@ -420,7 +490,8 @@ struct cpu_apply
                             fuse_match(match::gelu_tanh(),
                                        make_op("dnnl::eltwise", {{"algo", "eltwise_gelu_tanh"}}),
                                        {"x"}),
-                            fuse_match(match::layernorm(), make_op("dnnl::layernorm"), {"x"}));
+                            fuse_match(match::layernorm(), make_op("dnnl::layernorm"), {"x"}),
+                            find_attention());
         // Apply these operators first so the inputs can be const folded
         for(auto it : iterator_for(*modl))
         {
@@ -429,17 +500,154 @@ struct cpu_apply
                 apply_pow(it);
             }
         }
+        // Fuse after the matchers above, so they can still use the fused dnnl operators
+        if(mpm != nullptr)
+            fuse_pointwise{}.apply(*mpm);
+        std::vector<instruction_ref> pointwise_ins;
         for(auto it : iterator_for(*modl))
         {
             if(it->name() == "pooling")
             {
                 apply_pooling(it);
             }
+            else if(it->name() == "pointwise")
+            {
+                pointwise_ins.push_back(it);
+            }
             else if(apply_map.count(it->name()) > 0)
             {
                 apply_map.at(it->name())(it);
             }
         }
+        apply_pointwise(pointwise_ins);
+    }
+
+    // The dnnl operators that can fuse the operators that follow as post ops
+    static bool has_post_ops(instruction_ref ins)
+    {
+        return contains(
+            {"dnnl::convolution", "dnnl::quant_convolution", "dnnl::dot", "dnnl::quant_dot"},
+            ins->name());
+    }
+
+    // Check the operators form a chain, where each operator only reads the previous one once
+    bool is_post_op_chain(const std::vector<instruction_ref>& pinss, instruction_ref prev) const
+    {
+        return std::all_of(pinss.begin(), pinss.end(), [&](auto pins) {
+            if(not contains(post_op_names, pins->name()))
+                return false;
+            auto n = std::count(pins->inputs().begin(), pins->inputs().end(), prev);
+            if(n != 1 or prev->outputs().size() != 1)
+                return false;
+            prev = pins;
+            return true;
+        });
+    }
+
+    // A pointwise module is replaced with its operators when it is a single operator that is
+    // already lowered, or when it follows a dnnl convolution or gemm and every operator can be a
+    // dnnl post op, so the operators can still be fused with dnnl post ops
+    bool inline_pointwise(instruction_ref ins)
+    {
+        auto* pm = ins->module_inputs().front();
+        std::unordered_map<instruction_ref, instruction_ref> map_ins;
+        for(std::size_t i = 0; i < ins->inputs().size(); i++)
+        {
+            auto param = pm->get_parameter("x" + std::to_string(i));
+            if(param == pm->end())
+                return false;
+            map_ins[param] = ins->inputs()[i];
+        }
+        std::vector<instruction_ref> pinss;
+        for(auto pins : iterator_for(*pm))
+        {
+            if(contains({"@param", "@return"}, pins->name()))
+                continue;
+            pinss.push_back(pins);
+        }
+        if(pinss.empty())
+            return false;
+        if(pinss.size() > 1)
+        {
+            // The chain has to start from a dnnl convolution or gemm that is only used here
+            const auto& first = pinss.front()->inputs();
+            auto it           = std::find_if(first.begin(), first.end(), [&](auto input) {
+                if(not contains(map_ins, input))
+                    return false;
+                auto producer = map_ins.at(input);
+                return has_post_ops(producer) and producer->outputs().size() == 1;
+            });
+            if(it == first.end() or not is_post_op_chain(pinss, *it))
+                return false;
+        }
+        // Check the operators before changing the module
+        std::unordered_map<instruction_ref, shape> shapes;
+        for(auto pins : pinss)
+        {
+            if(apply_map.count(pins->name()) == 0)
+                return false;
+            std::vector<shape> input_shapes;
+            for(auto input : pins->inputs())
+            {
+                if(contains(map_ins, input))
+                    input_shapes.push_back(map_ins.at(input)->get_shape());
+                else if(contains(shapes, input))
+                    input_shapes.push_back(shapes.at(input));
+                else
+                    return false;
+            }
+            auto s = compute_shape(pins->get_operator(), input_shapes);
+            if(s != ins->get_shape())
+                return false;
+            shapes[pins] = s;
+        }
+        for(auto pins : pinss)
+        {
+            std::vector<instruction_ref> inputs;
+            std::transform(pins->inputs().begin(),
+                           pins->inputs().end(),
+                           std::back_inserter(inputs),
+                           [&](auto input) { return map_ins.at(input); });
+            auto op_ins   = modl->insert_instruction(ins, pins->get_operator(), inputs);
+            map_ins[pins] = apply_map.at(op_ins->name())(op_ins);
+        }
+        modl->replace_instruction(ins, map_ins.at(pinss.back()));
+        return true;
+    }
+
+    // Compile the other pointwise modules into kernels, the kernel is shared by the modules that
+    // generate the same source for the same shapes
+    void apply_pointwise(const std::vector<instruction_ref>& instructions)
+    {
+        std::vector<std::pair<std::string, std::vector<shape>>> kernels;
+        std::unordered_map<std::string, std::size_t> kernel_index;
+        std::vector<std::pair<instruction_ref, std::size_t>> compiled;
+        for(auto ins : instructions)
+        {
+            if(inline_pointwise(ins))
+                continue;
+            auto inputs = to_shapes(ins->inputs());
+            inputs.push_back(ins->get_shape());
+            if(std::any_of(inputs.begin(),
+                           inputs.end(),
+                           [](const shape& s) { return s.type() == shape::half_type; }) and
+               not pointwise_supports_half())
+                continue;
+            auto src = generate_pointwise(inputs, *ins->module_inputs().front());
+            auto key = src + to_string_range(inputs);
+            if(not contains(kernel_index, key))
+            {
+                kernel_index[key] = kernels.size();
+                kernels.emplace_back(src, inputs);
+            }
+            compiled.emplace_back(ins, kernel_index.at(key));
+        }
+        std::vector<operation> ops(kernels.size());
+        par_for(kernels.size(), 1, [&](auto i) {
+            ops[i] = compile_pointwise(kernels[i].first, kernels[i].second);
+        });
+        for(const auto& p : compiled)
+            replace(p.first, ops[p.second]);
     }
 
     instruction_ref apply_pow(instruction_ref ins) const
@@ -457,7 +665,10 @@ struct cpu_apply
     {
         auto&& op = ins->get_operator();
         auto v    = op.to_value();
-        if(has_op("dnnl::pooling") and ins->get_shape().type() == shape::type_t::float_type and
+        auto type = ins->get_shape().type();
+        if(has_op("dnnl::pooling") and
+           (type == shape::type_t::float_type or type == shape::type_t::half_type or
+            type == shape::type_t::bf16_type) and
            not v["ceil_mode"].to<bool>())
             return replace(ins, make_op("dnnl::pooling", op.to_value()));
         return ins;
@@ -494,7 +705,10 @@ struct cpu_apply
     }
 };
 
-void lowering::apply(module& m) const { cpu_apply{&m}.apply(); }
+void lowering::apply(module_pass_manager& mpm) const
+{
+    cpu_apply{&mpm.get_module(), pointwise_fusion ? &mpm : nullptr}.apply();
+}
 
 } // namespace cpu
 } // namespace MIGRAPHX_INLINE_NS
@@ -15,6 +15,9 @@ struct dnnl_reorder : dnnl_op<dnnl_reorder, dnnl::reorder>
     {
         check_shapes{inputs, *this}.has(2);
         auto r = inputs.back();
+        // The allocation is the buffer of the layout, so the output is the standard shape
+        if(not this->output_layout.empty())
+            r = shape{inputs.front().type(), inputs.front().lens()};
         // Call to get_primitive to make sure an algo is available
         this->get_primitive(this->to_memory_desc(r, inputs));
         return r;
@@ -0,0 +1,157 @@
+#include <migraphx/cpu/stream.hpp>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+struct event_impl
+{
+    std::mutex m;
+    std::condition_variable cv;
+    bool reached             = false;
+    std::exception_ptr error = nullptr;
+};
+
+event::event() : impl(std::make_shared<event_impl>()) {}
+
+void event::signal(std::exception_ptr e) const
+{
+    {
+        std::lock_guard<std::mutex> lock(impl->m);
+        impl->reached = true;
+        impl->error   = std::move(e);
+    }
+    impl->cv.notify_all();
+}
+
+void event::wait() const
+{
+    std::unique_lock<std::mutex> lock(impl->m);
+    impl->cv.wait(lock, [&] { return impl->reached; });
+    if(impl->error != nullptr)
+        std::rethrow_exception(impl->error);
+}
+
+struct stream_impl
+{
+    std::mutex m;
+    std::condition_variable cv;
+    std::deque<std::function<void()>> tasks;
+    std::size_t running      = 0;
+    bool stop                = false;
+    std::exception_ptr error = nullptr;
+    std::thread thread;
+
+    stream_impl() : thread([this] { this->work(); }) {}
+
+    stream_impl(const stream_impl&) = delete;
+    stream_impl& operator=(const stream_impl&) = delete;
+
+    ~stream_impl()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            stop = true;
+        }
+        cv.notify_all();
+        thread.join();
+    }
+
+    void push(std::function<void()> f)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            tasks.push_back(std::move(f));
+        }
+        cv.notify_all();
+    }
+
+    void set_error(std::exception_ptr e)
+    {
+        std::lock_guard<std::mutex> lock(m);
+        if(error == nullptr)
+            error = std::move(e);
+    }
+
+    std::exception_ptr get_error()
+    {
+        std::lock_guard<std::mutex> lock(m);
+        return error;
+    }
+
+    void work()
+    {
+        for(;;)
+        {
+            std::function<void()> f;
+            {
+                std::unique_lock<std::mutex> lock(m);
+                cv.wait(lock, [&] { return stop or not tasks.empty(); });
+                if(tasks.empty())
+                    return;
+                f = std::move(tasks.front());
+                tasks.pop_front();
+                running++;
+            }
+            try
+            {
+                f();
+            }
+            catch(...)
+            {
+                set_error(std::current_exception());
+            }
+            {
+                std::lock_guard<std::mutex> lock(m);
+                running--;
+            }
+            cv.notify_all();
+        }
+    }
+
+    void sync()
+    {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [&] { return tasks.empty() and running == 0; });
+        auto e = error;
+        error  = nullptr;
+        lock.unlock();
+        if(e != nullptr)
+            std::rethrow_exception(e);
+    }
+};
+
+stream::stream() : impl(std::make_shared<stream_impl>()) {}
+
+void stream::launch(std::function<void()> f) const { impl->push(std::move(f)); }
+
+void stream::record(const event& e) const
+{
+    auto* s = impl.get();
+    impl->push([=] { e.signal(s->get_error()); });
+}
+
+void stream::wait(const event& e) const
+{
+    auto* s = impl.get();
+    impl->push([=] {
+        try
+        {
+            e.wait();
+        }
+        catch(...)
+        {
+            s->set_error(std::current_exception());
+        }
+    });
+}
+
+void stream::sync() const { impl->sync(); }
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
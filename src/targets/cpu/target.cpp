@@ -10,8 +10,11 @@
 #include <migraphx/eliminate_data_type.hpp>
 #include <migraphx/eliminate_identity.hpp>
 #include <migraphx/eliminate_pad.hpp>
+#include <migraphx/inplace_elementwise.hpp>
 #include <migraphx/memory_coloring.hpp>
+#include <migraphx/pass_config.hpp>
 #include <migraphx/propagate_constant.hpp>
+#include <migraphx/reduce_peak_memory.hpp>
 #include <migraphx/register_target.hpp>
 #include <migraphx/rewrite_batchnorm.hpp>
 #include <migraphx/rewrite_pooling.hpp>
@@ -23,32 +26,122 @@
 #include <migraphx/simplify_qdq.hpp>
 #include <migraphx/simplify_reshapes.hpp>
 #include <migraphx/preallocate_param.hpp>
+#include <migraphx/cpu/assign_layouts.hpp>
 #include <migraphx/cpu/fuse_ops.hpp>
 #include <migraphx/cpu/write_literals.hpp>
 #include <migraphx/cpu/allocation_model.hpp>
+#include <migraphx/cpu/schedule_model.hpp>
 #include <migraphx/cpu/target.hpp>
 #include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/compile_pointwise.hpp>
+#include <migraphx/cpu/dnnl.hpp>
 #include <migraphx/cpu/lowering.hpp>
 #include <migraphx/pass.hpp>
 #include <migraphx/generate.hpp>
 #include <migraphx/normalize_ops.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/env.hpp>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_CPU_STREAMS)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_POINTWISE_FUSION)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_NATIVE_TYPES)
+
 std::string target::name() const { return "cpu"; }
 
+// The reduced precision types that are kept for the operators in native_ops, instead of being
+// computed in float
+static std::set<shape::type_t> native_types(bool pointwise_fusion)
+{
+    if(enabled(MIGRAPHX_DISABLE_NATIVE_TYPES{}))
+        return {};
+    std::set<shape::type_t> result;
+    if(dnnl_supports_type(shape::int8_type))
+        result = {shape::int8_type, shape::uint8_type, shape::int32_type};
+    // The fused pointwise kernels need to support half too, otherwise they are not compiled
+    if(dnnl_supports_type(shape::half_type) and
+       (not pointwise_fusion or pointwise_supports_half()))
+        result.insert(shape::half_type);
+    // The pointwise kernels store bf16 themselves, so it only needs dnnl
+    if(dnnl_supports_type(shape::bf16_type))
+        result.insert(shape::bf16_type);
+    return result;
+}
+
+static std::set<std::string> native_ops(const std::set<shape::type_t>& types)
+{
+    // These operators only move the data, and the quantized operators have dnnl kernels
+    std::set<std::string> result = {"broadcast",
+                                    "concat",
+                                    "contiguous",
+                                    "flatten",
+                                    "gather",
+                                    "multibroadcast",
+                                    "pad",
+                                    "quant_convolution",
+                                    "reshape",
+                                    "slice",
+                                    "squeeze",
+                                    "transpose",
+                                    "unsqueeze"};
+#ifndef MIGRAPHX_ENABLE_ZENDNN
+    // The gemms are only lowered to dnnl without zendnn
+    result.insert("quant_dot");
+#endif
+    if(contains(types, shape::half_type) or contains(types, shape::bf16_type))
+    {
+        // Operators lowered to dnnl, or fused into the pointwise kernels
+        result.insert({"abs",
+                       "add",
+                       "convolution",
+                       "div",
+                       "elu",
+                       "exp",
+                       "log",
+                       "logsoftmax",
+                       "lrn",
+                       "max",
+                       "min",
+                       "mul",
+                       "pooling",
+                       "reduce_max",
+                       "reduce_mean",
+                       "reduce_min",
+                       "reduce_sum",
+                       "relu",
+                       "softmax",
+                       "sqrt",
+                       "sub",
+                       "tanh"});
+#ifndef MIGRAPHX_ENABLE_ZENDNN
+        result.insert("dot");
+#endif
+    }
+    return result;
+}
+
 // cppcheck-suppress constParameter
 std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_options&) const
 {
     auto& ctx = any_cast<context>(gctx);
+    // Independent branches only run concurrently when more than one stream is requested
+    auto nstreams         = value_of(MIGRAPHX_CPU_STREAMS{}, 1);
+    auto pointwise_fusion = not enabled(MIGRAPHX_DISABLE_POINTWISE_FUSION{});
+    auto reduced_types    = native_types(pointwise_fusion);
     std::set<shape::type_t> unsupported_types(shape::types().begin(), shape::types().end());
     unsupported_types.erase(shape::type_t::float_type);
+    for(auto t : reduced_types)
+        unsupported_types.erase(t);
     return {normalize_ops{},
             rewrite_quantization{},
             dead_code_elimination{},
             eliminate_data_type{unsupported_types, shape::type_t::float_type},
+            // The operators without a native kernel compute the reduced precision types in float
+            eliminate_data_type{
+                reduced_types, shape::type_t::float_type, native_ops(reduced_types)},
             dead_code_elimination{},
             simplify_reshapes{},
             eliminate_identity{},
@@ -67,15 +160,23 @@ std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_opti
             simplify_reshapes{},
             propagate_constant{},
             dead_code_elimination{},
-            lowering{},
+            lowering{pointwise_fusion},
             eliminate_contiguous{"dnnl::reorder"},
             dead_code_elimination{},
             adjust_allocation{cpu_allocation_model{}},
             dead_code_elimination{},
             fuse_ops{&ctx},
             dead_code_elimination{},
-            write_literals{},
+            assign_layouts{&ctx},
+            dead_code_elimination{},
+            write_literals{&ctx},
+            dead_code_elimination{},
+            inplace_elementwise{cpu_allocation_model{}},
             dead_code_elimination{},
+            reduce_peak_memory{"cpu::allocate", enabled(MIGRAPHX_ENABLE_REDUCE_PEAK_MEMORY{})},
+            schedule{cpu::schedule_model{nstreams},
+                     nstreams > 1,
+                     enabled(MIGRAPHX_ENABLE_REDUCE_PEAK_MEMORY{})},
             memory_coloring{"cpu::allocate"},
             dead_code_elimination{},
             preallocate_param{"scratch", cpu_allocation_model{}},
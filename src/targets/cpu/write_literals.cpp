@@ -1,4 +1,6 @@
 #include <migraphx/cpu/write_literals.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/context.hpp>
 #include <migraphx/module.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/iterator_for.hpp>
@@ -10,18 +12,27 @@ namespace cpu {
 struct cpu_literal
 {
     argument data;
+    // The data can be stored in a padded layout, so the shape of the output can be different
+    shape s;
 
     template <class Self, class F>
     static auto reflect(Self& self, F f)
     {
-        return pack(f(self.data, "data"));
+        return pack(f(self.data, "data"), f(self.s, "shape"));
     }
 
     std::string name() const { return "cpu::literal"; }
 
-    shape compute_shape(const std::vector<shape>&) const { return data.get_shape(); }
+    value attributes() const { return {{"literal", true}}; }
 
-    argument compute(const shape&, const std::vector<argument>&) const { return data; }
+    shape compute_shape(const std::vector<shape>&) const { return s; }
+
+    argument compute(const shape& output_shape, const std::vector<argument>&) const
+    {
+        if(data.get_shape() == output_shape)
+            return data;
+        return data.reshape(output_shape);
+    }
 
     friend std::ostream& operator<<(std::ostream& os, const cpu_literal& x)
     {
@@ -30,13 +41,36 @@ struct cpu_literal
     }
 };
 
+// Reorder the literal once, instead of every time the program runs
+static argument fold_reorder(migraphx::context& ctx, instruction_ref ins)
+{
+    auto op     = ins->get_operator();
+    auto inputs = to_shapes(ins->inputs());
+    op.finalize(ctx, ins->get_shape(), inputs);
+    argument result{inputs.back()};
+    auto input = ins->inputs().front()->get_literal().get_argument();
+    op.compute(ctx, ins->get_shape(), {input, result});
+    return result;
+}
+
 void write_literals::apply(module& m) const
 {
+    if(ctx != nullptr)
+    {
+        migraphx::context gctx = std::ref(*ctx);
+        for(auto ins : iterator_for(m))
+        {
+            if(ins->name() != "dnnl::reorder" or ins->inputs().front()->name() != "@literal")
+                continue;
+            m.replace_instruction(ins, cpu_literal{fold_reorder(gctx, ins), ins->get_shape()});
+        }
+    }
     for(auto ins : iterator_for(m))
     {
         if(ins->name() != "@literal")
             continue;
-        m.replace_instruction(ins, cpu_literal{ins->get_literal().get_argument()});
+        auto a = ins->get_literal().get_argument();
+        m.replace_instruction(ins, cpu_literal{a, a.get_shape()});
     }
 }
 
@@ -10,6 +10,7 @@
 
 #include <hip/hip_runtime.h>
 #include <migraphx/half.hpp>
+#include <migraphx/bf16.hpp>
 #include <migraphx/config.hpp>
 #include <migraphx/tensor_view.hpp>
 
@@ -51,6 +52,42 @@ auto pack_vec(Ts... xs)
 
 using gpu_half = __fp16;
 
+// The conversions of bf16 are host only, so the device code uses this type with the same layout
+struct gpu_bf16
+{
+    std::uint16_t data;
+
+    gpu_bf16() = default;
+
+    __device__ __host__ gpu_bf16(float x) : data(from_float(x)) {}
+
+    __device__ __host__ operator float() const
+    {
+        bits_type b{};
+        b.u = std::uint32_t{data} << 16u;
+        return b.f;
+    }
+
+    private:
+    union bits_type
+    {
+        float f;
+        std::uint32_t u;
+    };
+
+    // Round to the nearest even value
+    static __device__ __host__ std::uint16_t from_float(float x)
+    {
+        bits_type b{};
+        b.f = x;
+        // Keep nan quiet, since rounding could turn it into infinity
+        if((b.u & 0x7fffffffu) > 0x7f800000u)
+            return (b.u >> 16u) | 0x40u;
+        b.u += 0x7fffu + ((b.u >> 16u) & 1u);
+        return b.u >> 16u;
+    }
+};
+
 namespace detail {
 template <class T>
 struct device_type
@@ -70,6 +107,12 @@ struct device_type<half>
     using type = gpu_half;
 };
 
+template <>
+struct device_type<bf16>
+{
+    using type = gpu_bf16;
+};
+
 template <class T>
 struct host_type
 {
@@ -82,6 +125,12 @@ struct host_type<gpu_half>
     using type = half;
 };
 
+template <>
+struct host_type<gpu_bf16>
+{
+    using type = bf16;
+};
+
 } // namespace detail
 
 template <class T>
@@ -129,6 +178,8 @@ __device__ __host__ T to_hip_type(T x)
 // Hip doens't support __fp16
 inline __device__ __host__ float to_hip_type(gpu_half x) { return x; }
 
+inline __device__ __host__ float to_hip_type(gpu_bf16 x) { return x; }
+
 #define MIGRAPHX_DETAIL_EXTEND_TRAIT_FOR(trait, T) \
     template <class X>                             \
     struct trait : std::trait<X>                   \
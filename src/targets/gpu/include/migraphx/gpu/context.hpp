@@ -226,6 +226,7 @@ struct context
         value result;
         result["events"]  = events.size();
         result["streams"] = current_device->nstreams();
+        result["arch"]    = current_device->get_device_name();
 
         return result;
     }
@@ -6,6 +6,7 @@
 #include <migraphx/literal.hpp>
 #include <migraphx/check_shapes.hpp>
 #include <migraphx/functional.hpp>
+#include <migraphx/value.hpp>
 #include <utility>
 
 namespace migraphx {
@@ -224,6 +225,7 @@ struct hip_copy_literal
     }
 
     std::string name() const { return "hip::hip_copy_literal"; }
+    value attributes() const { return {{"literal", true}}; }
     shape compute_shape(const std::vector<shape>& inputs) const
     {
         check_shapes{inputs, *this}.has(0);
@@ -14,8 +14,10 @@
 #include <migraphx/insert_pad.hpp>
 #include <migraphx/memory_coloring.hpp>
 #include <migraphx/normalize_ops.hpp>
+#include <migraphx/pass_config.hpp>
 #include <migraphx/preallocate_param.hpp>
 #include <migraphx/propagate_constant.hpp>
+#include <migraphx/reduce_peak_memory.hpp>
 #include <migraphx/register_target.hpp>
 #include <migraphx/rewrite_batchnorm.hpp>
 #include <migraphx/rewrite_pooling.hpp>
@@ -117,7 +119,10 @@ std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_opti
         compile_ops{&ctx},
         dead_code_elimination{},
         write_literals{&ctx},
-        schedule{gpu::schedule_model{ctx.get_current_device().nstreams()}, not enabled(MIGRAPHX_DISABLE_SCHEDULE_PASS{})},
+        reduce_peak_memory{"hip::allocate", enabled(MIGRAPHX_ENABLE_REDUCE_PEAK_MEMORY{})},
+        schedule{gpu::schedule_model{ctx.get_current_device().nstreams()},
+                 not enabled(MIGRAPHX_DISABLE_SCHEDULE_PASS{}),
+                 enabled(MIGRAPHX_ENABLE_REDUCE_PEAK_MEMORY{})},
         memory_coloring{"hip::allocate"},
         sync_device{},
         preallocate_param{"scratch", gpu_allocation_model{}},
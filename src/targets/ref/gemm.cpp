@@ -1,8 +1,9 @@
 #include <migraphx/ref/gemm.hpp>
-#include <migraphx/dfor.hpp>
 #include <migraphx/requires.hpp>
 #include <migraphx/par_for.hpp>
 #include <blaze/math/CustomMatrix.h>
+#include <algorithm>
+#include <numeric>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -11,27 +12,64 @@ namespace ref {
 template <class T>
 using matrix = blaze::CustomMatrix<T, blaze::unaligned, blaze::unpadded>; // NOLINT
 
+// The rows, columns and strides of a matrix in a batch of matrices
+struct matrix_view
+{
+    std::size_t rows;
+    std::size_t columns;
+    std::size_t row_stride;
+    std::size_t column_stride;
+
+    explicit matrix_view(const shape& s)
+        : rows(s.lens()[s.lens().size() - 2]),
+          columns(s.lens().back()),
+          row_stride(s.strides()[s.strides().size() - 2]),
+          column_stride(s.strides().back())
+    {
+    }
+
+    bool row_major() const { return column_stride == 1 and row_stride >= columns; }
+    bool column_major() const { return row_stride == 1 and column_stride >= rows; }
+};
+
+static std::size_t batch_count(const shape& s)
+{
+    const auto& lens = s.lens();
+    return std::accumulate(
+        lens.begin(), lens.end() - 2, std::size_t{1}, std::multiplies<std::size_t>());
+}
+
+// Offset of the matrix `b` in a batch of matrices, which can be broadcasted or transposed in the
+// batch dimensions
+static std::size_t batch_offset(const shape& s, std::size_t b)
+{
+    const auto& lens    = s.lens();
+    const auto& strides = s.strides();
+    std::size_t result  = 0;
+    for(std::size_t d = lens.size() - 2; d > 0; d--)
+    {
+        result += (b % lens[d - 1]) * strides[d - 1];
+        b /= lens[d - 1];
+    }
+    return result;
+}
+
 template <class T>
-static auto make_mat(tensor_view<T> x)
+static auto make_mat(T* data, const matrix_view& m)
 {
-    const auto& s = x.get_shape();
-    // assert(s.lens().size() == 2);
-    std::size_t n_dims = s.lens().size();
-    std::size_t dim_0  = n_dims - 2;
-    std::size_t dim_1  = n_dims - 1;
-    if(s.transposed())
-        return matrix<T>{x.data(), s.lens()[dim_1], s.lens()[dim_0], s.strides()[dim_1]};
-    return matrix<T>{x.data(), s.lens()[dim_0], s.lens()[dim_1], s.strides()[dim_0]};
+    if(m.row_major())
+        return matrix<T>{data, m.rows, m.columns, m.row_stride};
+    return matrix<T>{data, m.columns, m.rows, m.column_stride};
 }
 
 template <class T, class F>
-static void visit_mat(tensor_view<T> x, F f)
+static void visit_mat(T* data, const matrix_view& m, F f)
 {
-    auto mat = make_mat(x);
-    if(x.get_shape().transposed())
-        f(blaze::trans(mat));
-    else
+    auto mat = make_mat(data, m);
+    if(m.row_major())
         f(mat);
+    else
+        f(blaze::trans(mat));
 }
 
 template <class T>
@@ -48,55 +86,99 @@ template <class T, class F>
 void migemm_impl(
     tensor_view<T> cmat, tensor_view<T> amat, tensor_view<T> bmat, F alpha, F beta, std::true_type)
 {
-    visit_mat(amat, [&](const auto& a) {
-        visit_mat(bmat, [&](const auto& b) {
-            auto c = make_mat(cmat);
-            c      = beta * c;
-            // This is a simple optimization to avoid
-            // compute A * B if alpha is 0.0
-            if(alpha != 0.0)
-            {
-                c = c + alpha * a * b;
-            }
+    matrix_view cm{cmat.get_shape()};
+    matrix_view am{amat.get_shape()};
+    matrix_view bm{bmat.get_shape()};
+    auto batches = batch_count(cmat.get_shape());
+    // Run the batches in parallel, so each blaze call is serial when there is more than one
+    par_for(batches, 1, [&](auto i) {
+        visit_mat(amat.data() + batch_offset(amat.get_shape(), i), am, [&](const auto& a) {
+            visit_mat(bmat.data() + batch_offset(bmat.get_shape(), i), bm, [&](const auto& b) {
+                auto c = make_mat(cmat.data() + batch_offset(cmat.get_shape(), i), cm);
+                c      = beta * c;
+                // This is a simple optimization to avoid
+                // compute A * B if alpha is 0.0
+                if(alpha == 0.0)
+                    return;
+                if(batches > 1)
+                    c = c + alpha * blaze::serial(a * b);
+                else
+                    c = c + alpha * a * b;
+            });
         });
     });
 }
 
-template <class T, class F>
+// Tiled kernel for the types blaze is not used for. Each task computes a tile of the output, and
+// accumulates its rows in a local buffer, so a row of b is loaded once for all the rows of the tile
+// and the loop over the columns is contiguous when b is row major.
+template <class T, class U, class F>
 void migemm_impl(
-    tensor_view<T> cmat, tensor_view<T> amat, tensor_view<T> bmat, F alpha, F beta, std::false_type)
+    tensor_view<T> cmat, tensor_view<U> amat, tensor_view<U> bmat, F alpha, F beta, std::false_type)
 {
-    std::size_t n_dims = cmat.get_shape().lens().size();
-    std::size_t dim_0  = n_dims - 2;
-    std::size_t dim_1  = n_dims - 1;
-    auto k             = amat.get_shape().lens()[dim_1];
-
-    assert(amat.get_shape().lens()[dim_1] == bmat.get_shape().lens()[dim_0]);
-    assert(cmat.get_shape().lens()[dim_0] == amat.get_shape().lens()[dim_0]);
-    assert(cmat.get_shape().lens()[dim_1] == bmat.get_shape().lens()[dim_1]);
-    auto cs = cmat.get_shape();
-
-    par_for(cs.elements(), [&](auto i) {
-        auto c_idx = cs.multi(i);
-        auto a_idx = c_idx;
-        auto b_idx = c_idx;
-        double s   = 0.0;
-        dfor(k)([&](auto kk) {
-            a_idx[dim_1] = b_idx[dim_0] = kk;
-            s += amat(a_idx.begin(), a_idx.end()) * bmat(b_idx.begin(), b_idx.end());
-        });
-        cmat(c_idx.begin(), c_idx.end()) = alpha * s + cmat(c_idx.begin(), c_idx.end()) * beta;
+    using accumulator = std::conditional_t<std::is_integral<T>{}, int64_t, double>;
+    constexpr std::size_t tile_rows    = 16;
+    constexpr std::size_t tile_columns = 64;
+
+    matrix_view cm{cmat.get_shape()};
+    matrix_view am{amat.get_shape()};
+    matrix_view bm{bmat.get_shape()};
+    assert(am.columns == bm.rows);
+    assert(cm.rows == am.rows);
+    assert(cm.columns == bm.columns);
+    auto k            = am.columns;
+    auto batches      = batch_count(cmat.get_shape());
+    auto row_tiles    = (cm.rows + tile_rows - 1) / tile_rows;
+    auto column_tiles = (cm.columns + tile_columns - 1) / tile_columns;
+    auto tiles        = row_tiles * column_tiles;
+
+    par_for(batches * tiles, 1, [&](auto i) {
+        auto batch  = i / tiles;
+        auto row    = ((i % tiles) / column_tiles) * tile_rows;
+        auto column = (i % column_tiles) * tile_columns;
+        auto nrows  = std::min(tile_rows, cm.rows - row);
+        auto ncols  = std::min(tile_columns, cm.columns - column);
+        const U* a  = amat.data() + batch_offset(amat.get_shape(), batch) + row * am.row_stride;
+        const U* b =
+            bmat.data() + batch_offset(bmat.get_shape(), batch) + column * bm.column_stride;
+        T* c = cmat.data() + batch_offset(cmat.get_shape(), batch) + row * cm.row_stride +
+               column * cm.column_stride;
+
+        accumulator acc[tile_rows][tile_columns] = {};
+        for(std::size_t kk = 0; kk < k; kk++)
+        {
+            const U* brow = b + kk * bm.row_stride;
+            for(std::size_t r = 0; r < nrows; r++)
+            {
+                accumulator x = a[r * am.row_stride + kk * am.column_stride];
+                for(std::size_t j = 0; j < ncols; j++)
+                    acc[r][j] += x * accumulator(brow[j * bm.column_stride]);
+            }
+        }
+        for(std::size_t r = 0; r < nrows; r++)
+        {
+            for(std::size_t j = 0; j < ncols; j++)
+            {
+                auto& y = c[r * cm.row_stride + j * cm.column_stride];
+                // Avoid reading the output when beta is zero, since it can be uninitialized
+                if(beta == 0)
+                    y = alpha * acc[r][j];
+                else
+                    y = alpha * acc[r][j] + y * beta;
+            }
+        }
     });
 }
 
 template <class T, class F>
 void migemm_impl(tensor_view<T> cmat, tensor_view<T> amat, tensor_view<T> bmat, F alpha, F beta)
 {
-    auto lens = amat.get_shape().lens();
-    bool batch_mul =
-        std::accumulate(
-            lens.rbegin() + 2, lens.rend(), std::size_t{1}, std::multiplies<std::size_t>()) == 1;
-    if(batch_mul)
+    matrix_view cm{cmat.get_shape()};
+    matrix_view am{amat.get_shape()};
+    matrix_view bm{bmat.get_shape()};
+    bool blaze_layout = cm.row_major() and (am.row_major() or am.column_major()) and
+                        (bm.row_major() or bm.column_major());
+    if(is_fast_gemm_type<T>{} and blaze_layout)
     {
         migemm_impl(cmat, amat, bmat, alpha, beta, is_fast_gemm_type<T>{});
     }
@@ -126,6 +208,19 @@ void migemm(const argument& c_arg,
             int32_t alpha,
             int32_t beta)
 {
+    // Multiply int8 operands directly into an int32 result, without converting them first
+    if(c_arg.get_shape().type() == shape::int32_type and
+       a_arg.get_shape().type() == shape::int8_type and
+       b_arg.get_shape().type() == shape::int8_type)
+    {
+        migemm_impl(c_arg.get<int32_t>(),
+                    a_arg.get<int8_t>(),
+                    b_arg.get<int8_t>(),
+                    alpha,
+                    beta,
+                    std::false_type{});
+        return;
+    }
     migemm_tpl(c_arg, a_arg, b_arg, alpha, beta);
 }
 
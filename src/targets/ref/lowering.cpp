@@ -28,6 +28,7 @@
 #include <migraphx/register_op.hpp>
 #include <migraphx/make_op.hpp>
 #include <migraphx/tune_axis.hpp>
+#include <numeric>
 #include <unordered_map>
 #include <utility>
 #include <iostream>
@@ -96,8 +97,8 @@ struct ref_batch_norm_inference
             visit_all(output, input, mini_batch_mean, mini_batch_variance, arg_gamma, arg_bias)(
                 [&](auto result, auto buffer, auto mean, auto variance, auto gamma, auto bias) {
                     par_for(output_shape.elements(), [&](auto i) {
-                        auto idx = output_shape.multi(i);
-                        auto c   = idx[1];
+                        multi_index idx{output_shape, i};
+                        auto c = idx[1];
                         assert((variance[c] + epsilon) > 0);
                         result[i] =
                             gamma[c] * (buffer[i] - mean[c]) / std::sqrt(variance[c] + epsilon) +
@@ -111,7 +112,7 @@ struct ref_batch_norm_inference
             visit_all(output, input, mini_batch_mean, mini_batch_variance, arg_gamma, arg_bias)(
                 [&](auto result, auto buffer, auto mean, auto variance, auto gamma, auto bias) {
                     par_for(output_shape.elements(), [&](auto i) {
-                        auto idx   = output_shape.multi(i);
+                        multi_index idx{output_shape, i};
                         idx[0]     = 0;
                         auto index = output_shape.index(idx);
 
@@ -211,59 +212,118 @@ struct ref_convolution : auto_register_op<ref_convolution<Op>>
     argument compute(context&, shape output_shape, std::vector<argument> args) const
     {
         argument result{output_shape};
-        visit_quantize(result, args[0], args[1])([&](auto output, auto input, auto weights) {
-            auto in_lens = input.get_shape().lens();
-
-            auto wei_lens = weights.get_shape().lens();
-            auto wei_n    = wei_lens[0];
-            auto wei_c    = wei_lens[1];
-            std::vector<std::size_t> win_size(wei_lens.begin() + 1, wei_lens.end());
+        const auto& in_shape  = args[0].get_shape();
+        const auto& wei_shape = args[1].get_shape();
+        auto type             = output_shape.type();
+        auto ndim             = output_shape.lens().size() - 2;
+        auto batches          = output_shape.lens()[0];
+        auto groups           = std::size_t(op.group);
+        auto wei_n            = wei_shape.lens()[0] / groups;
+        auto wei_c            = wei_shape.lens()[1];
+        std::vector<std::size_t> win_lens(wei_shape.lens().begin() + 2, wei_shape.lens().end());
+        std::vector<std::size_t> pos_lens(output_shape.lens().begin() + 2,
+                                          output_shape.lens().end());
+        auto win_size = std::accumulate(
+            win_lens.begin(), win_lens.end(), std::size_t{1}, std::multiplies<>{});
+        // The rows of the column matrix are the input channels and window positions of a group,
+        // and its columns are the output positions
+        auto rows    = wei_c * win_size;
+        auto columns = std::accumulate(
+            pos_lens.begin(), pos_lens.end(), std::size_t{1}, std::multiplies<>{});
+
+        // Compute the offsets of each window position and the start of each output position in
+        // every spatial dimension once, instead of for every element
+        std::vector<std::ptrdiff_t> win_offsets(win_size * ndim);
+        std::vector<std::ptrdiff_t> pos_starts(columns * ndim);
+        for(std::size_t i = 0; i < win_size; i++)
+        {
+            auto j = i;
+            for(std::size_t d = ndim; d > 0; d--)
+            {
+                auto k = d - 1;
+                win_offsets[i * ndim + k] = std::ptrdiff_t((j % win_lens[k]) * op.dilation[k]) -
+                                            std::ptrdiff_t(op.padding[k]);
+                j /= win_lens[k];
+            }
+        }
+        for(std::size_t i = 0; i < columns; i++)
+        {
+            auto j = i;
+            for(std::size_t d = ndim; d > 0; d--)
+            {
+                auto k                   = d - 1;
+                pos_starts[i * ndim + k] = (j % pos_lens[k]) * op.stride[k];
+                j /= pos_lens[k];
+            }
+        }
 
-            par_for(output_shape.elements(), [&](auto i) {
-                auto idx_o = output_shape.multi(i);
-                auto w     = idx_o[1];
-                auto n_dim = idx_o.size();
+        // The gemm is done in the output type, so quantized weights are converted first
+        auto weights = args[1];
+        if(wei_shape.type() != type or not wei_shape.standard())
+        {
+            weights = argument{shape{type, wei_shape.lens()}};
+            weights.visit([&](auto out) {
+                args[1].visit([&](auto in) { std::copy(in.begin(), in.end(), out.begin()); });
+            });
+        }
 
-                std::vector<std::ptrdiff_t> win_start;
-                for(std::size_t dim = 2; dim < n_dim; ++dim)
-                {
-                    auto d_2 = dim - 2;
-                    win_start.push_back(std::ptrdiff_t(idx_o[dim] * op.stride[d_2]) -
-                                        std::ptrdiff_t(op.padding[d_2]));
-                }
-                const auto group_id = w / (wei_n / op.group);
-
-                shape win_shape{output_shape.type(), win_size};
-
-                double acc = 0.0;
-                shape_for_each(win_shape, [&](auto idx_win) {
-                    auto k           = idx_win[0];
-                    const auto in_ch = group_id * wei_c + k;
-                    std::vector<std::ptrdiff_t> idx(idx_o.begin(), idx_o.end());
-                    idx[1] = in_ch;
-                    std::transform(idx_win.begin() + 1,
-                                   idx_win.end(),
-                                   win_start.begin(),
-                                   idx.begin() + 2,
-                                   [](std::ptrdiff_t ii, std::ptrdiff_t jj) { return ii + jj; });
-                    std::vector<std::ptrdiff_t> idx_wei(idx_o.size());
-                    idx_wei[0] = w;
-                    std::copy(idx_win.begin(), idx_win.end(), idx_wei.begin() + 1);
-                    if(std::all_of(idx.begin() + 2, idx.end(), [&](auto ii) { return ii >= 0; }) and
-                       std::equal(idx.begin(),
-                                  idx.end(),
-                                  in_lens.begin(),
-                                  in_lens.end(),
-                                  std::less<std::ptrdiff_t>{}))
-                    {
-                        acc +=
-                            input(idx.begin(), idx.end()) * weights(idx_wei.begin(), idx_wei.end());
-                    }
+        // Convert as many batches at once as fit in the column buffer
+        const std::size_t max_buffer = std::size_t{1} << 26;
+        auto chunk = std::max<std::size_t>(
+            1, std::min(batches, max_buffer / std::max<std::size_t>(1, groups * rows * columns)));
+        argument cols{shape{type, {chunk * groups * rows, columns}}};
+        const auto& in_lens    = in_shape.lens();
+        const auto& in_strides = in_shape.strides();
+        for(std::size_t n0 = 0; n0 < batches; n0 += chunk)
+        {
+            auto nb = std::min(chunk, batches - n0);
+            cols.visit([&](auto col) {
+                args[0].visit([&](auto input) {
+                    par_for(nb * groups * rows, [&](auto r) {
+                        auto row       = r % rows;
+                        auto n         = n0 + r / (groups * rows);
+                        auto channel   = ((r / rows) % groups) * wei_c + row / win_size;
+                        const auto* wo = win_offsets.data() + (row % win_size) * ndim;
+                        const auto* x  = input.data() + n * in_strides[0] + channel * in_strides[1];
+                        auto* y        = col.data() + r * columns;
+                        for(std::size_t p = 0; p < columns; p++)
+                        {
+                            const auto* ps     = pos_starts.data() + p * ndim;
+                            std::ptrdiff_t idx = 0;
+                            bool inside        = true;
+                            for(std::size_t d = 0; d < ndim; d++)
+                            {
+                                auto i = ps[d] + wo[d];
+                                inside = inside and i >= 0 and i < std::ptrdiff_t(in_lens[d + 2]);
+                                idx += i * std::ptrdiff_t(in_strides[d + 2]);
+                            }
+                            // Assign zero separately, so the ternary doesn't convert the
+                            // element to an int
+                            if(inside)
+                                y[p] = x[idx];
+                            else
+                                y[p] = 0;
+                        }
+                    });
                 });
-
-                output[i] = acc;
             });
-        });
+            // Multiply the weights of each group with its column matrix
+            auto type_size = output_shape.type_size();
+            for(std::size_t i = 0; i < nb * groups; i++)
+            {
+                auto group = i % groups;
+                auto n     = n0 + i / groups;
+                argument c{shape{type, {wei_n, columns}},
+                           result.data() + (n * groups + group) * wei_n * columns * type_size};
+                argument a{shape{type, {wei_n, rows}},
+                           weights.data() + group * wei_n * rows * type_size};
+                argument b{shape{type, {rows, columns}}, cols.data() + i * rows * columns * type_size};
+                if(type == shape::int32_type)
+                    migemm(c, a, b, int32_t{1}, int32_t{0});
+                else
+                    migemm(c, a, b, 1.0f, 0.0f);
+            }
+        }
         return result;
     }
 };
@@ -390,7 +450,7 @@ struct ref_pad
 
         visit_all(result, args[0])([&](auto output, auto input) {
             shape_for_each(input.get_shape(), [&](const auto& idx) {
-                std::vector<std::size_t> new_idx(idx.size());
+                auto new_idx = idx;
                 std::transform(
                     idx.begin(), idx.end(), op.pads.begin(), new_idx.begin(), [](auto i, auto j) {
                         return i + j;
@@ -442,20 +502,7 @@ struct ref_quant_gemm
     argument compute(context&, const shape& output_shape, std::vector<argument> args) const
     {
         argument result{output_shape};
-        // first, convert the args[0] and args[1] from int8_t to int32_t
-        argument arg_0{{shape::int32_type, {args.at(0).get_shape().lens()}}};
-        argument arg_1{{shape::int32_type, {args.at(1).get_shape().lens()}}};
-        arg_0.visit([&](auto output) {
-            args.at(0).visit(
-                [&](auto input) { std::copy(input.begin(), input.end(), output.begin()); });
-        });
-
-        arg_1.visit([&](auto output) {
-            args.at(1).visit(
-                [&](auto input) { std::copy(input.begin(), input.end(), output.begin()); });
-        });
-
-        migemm(result, arg_0, arg_1, int32_t{1}, int32_t{0});
+        migemm(result, args[0], args[1], int32_t{1}, int32_t{0});
 
         return result;
     }
@@ -556,7 +603,7 @@ struct ref_softmax : auto_register_op<ref_softmax<Op>>
                                               std::numeric_limits<value_type>::lowest());
             std::vector<value_type> batch_sum(batch_shape.elements(), value_type(0));
             par_for(batch_shape.elements(), [&](auto i) {
-                auto idx = batch_shape.multi(i);
+                multi_index idx{batch_shape, i};
                 for(std::size_t j = 0; j < n_dims; ++j)
                 {
                     idx[tuned_axis] = j;
@@ -617,8 +664,8 @@ struct ref_rnn_var_sl_last_output
         visit_all(result, args[0])([&](auto output, auto input) {
             args[1].visit([&](auto seq_lens) {
                 par_for(output_shape.elements(), [&](auto i) {
-                    auto idx = out_comp_s.multi(i);
-                    auto b   = idx[2];
+                    multi_index idx{out_comp_s, i};
+                    auto b = idx[2];
                     if(op.direction == op::rnn_direction::reverse or idx[1] == 1)
                     {
                         idx[0] = 0;
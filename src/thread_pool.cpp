@@ -0,0 +1,349 @@
+#include <migraphx/thread_pool.hpp>
+#include <migraphx/env.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_NUM_THREADS)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_PIN_THREADS)
+
+namespace {
+
+using range_function = std::function<void(std::size_t, std::size_t, std::size_t)>;
+
+// Maximum number of ranges waiting in the queue of one thread
+const std::size_t queue_capacity = 64;
+
+// Each loop is cut into at most this many ranges per thread, whatever the grain requested
+const std::size_t ranges_per_thread = 8;
+
+// Tracks the ranges of one parallel loop. It lives on the stack of the calling thread, so it is
+// only safe to destroy after the last range has finished under the lock.
+struct task_group
+{
+    const range_function* f = nullptr;
+    std::size_t grain       = 1;
+    std::size_t remaining   = 1;
+    std::size_t pushed      = 0;
+    std::exception_ptr error = nullptr;
+    std::atomic<bool> failed{false};
+    std::vector<std::atomic<bool>> tids;
+    std::mutex m;
+    std::condition_variable cv;
+
+    task_group(const range_function& pf, std::size_t pgrain, std::size_t n)
+        : f(&pf), grain(pgrain), tids(n)
+    {
+    }
+
+    std::size_t acquire_tid()
+    {
+        // A thread only runs one range of a loop at a time, so there is always a free tid
+        for(;;)
+        {
+            for(std::size_t i = 0; i < tids.size(); i++)
+            {
+                bool used = false;
+                if(tids[i].compare_exchange_strong(used, true))
+                    return i;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    void release_tid(std::size_t i) { tids[i] = false; }
+
+    void add_range()
+    {
+        std::lock_guard<std::mutex> lock(m);
+        remaining++;
+    }
+
+    void notify_pushed()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            pushed++;
+        }
+        cv.notify_all();
+    }
+
+    void fail(std::exception_ptr e)
+    {
+        std::lock_guard<std::mutex> lock(m);
+        if(error == nullptr)
+            error = std::move(e);
+        failed = true;
+    }
+
+    void finish()
+    {
+        std::lock_guard<std::mutex> lock(m);
+        remaining--;
+        if(remaining == 0)
+            cv.notify_all();
+    }
+};
+
+struct range_task
+{
+    task_group* group = nullptr;
+    std::size_t start = 0;
+    std::size_t end   = 0;
+};
+
+struct task_queue
+{
+    std::mutex m;
+    std::deque<range_task> tasks;
+    std::atomic<std::size_t> size{0};
+};
+
+struct worker_id
+{
+    const thread_pool_impl* pool = nullptr;
+    std::size_t index            = 0;
+};
+
+thread_local worker_id current_worker = {};
+
+void pin_thread(std::size_t cpu)
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu % std::max(1u, std::thread::hardware_concurrency()), &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
+
+} // namespace
+
+// Queue 0 is shared by the threads that are not part of the pool, queue i belongs to worker i
+struct thread_pool_impl
+{
+    std::vector<task_queue> queues;
+    std::atomic<std::size_t> pending{0};
+    std::mutex m;
+    std::condition_variable cv;
+    bool stop = false;
+    std::vector<std::thread> workers;
+
+    explicit thread_pool_impl(std::size_t n) : queues(n) {}
+
+    std::size_t current_index() const
+    {
+        return current_worker.pool == this ? current_worker.index : 0;
+    }
+
+    bool push(std::size_t idx, const range_task& t)
+    {
+        auto& q = queues[idx];
+        // Count the range before it can be stolen and finished
+        t.group->add_range();
+        {
+            std::lock_guard<std::mutex> lock(q.m);
+            if(q.tasks.size() >= queue_capacity)
+            {
+                // The range running on this thread keeps the group alive
+                t.group->finish();
+                return false;
+            }
+            q.tasks.push_back(t);
+            q.size++;
+            pending++;
+        }
+        t.group->notify_pushed();
+        {
+            std::lock_guard<std::mutex> lock(m);
+        }
+        cv.notify_one();
+        return true;
+    }
+
+    // The owner takes the newest range, thieves take the oldest one
+    bool take_from(task_queue& q, const task_group* g, bool owner, range_task& t)
+    {
+        if(q.size == 0)
+            return false;
+        std::lock_guard<std::mutex> lock(q.m);
+        auto match = [&](const range_task& x) { return g == nullptr or x.group == g; };
+        if(owner)
+        {
+            auto it = std::find_if(q.tasks.rbegin(), q.tasks.rend(), match);
+            if(it == q.tasks.rend())
+                return false;
+            t = *it;
+            q.tasks.erase(std::next(it).base());
+        }
+        else
+        {
+            auto it = std::find_if(q.tasks.begin(), q.tasks.end(), match);
+            if(it == q.tasks.end())
+                return false;
+            t = *it;
+            q.tasks.erase(it);
+        }
+        q.size--;
+        pending--;
+        return true;
+    }
+
+    // Take any range when g is null, otherwise only a range of that loop
+    bool take(std::size_t idx, const task_group* g, range_task& t)
+    {
+        if(pending == 0)
+            return false;
+        if(take_from(queues[idx], g, true, t))
+            return true;
+        for(std::size_t i = 1; i < queues.size(); i++)
+        {
+            if(take_from(queues[(idx + i) % queues.size()], g, false, t))
+                return true;
+        }
+        return false;
+    }
+
+    void execute(range_task t, std::size_t idx)
+    {
+        auto& g  = *t.group;
+        auto tid = g.acquire_tid();
+        try
+        {
+            while(t.start < t.end and not g.failed)
+            {
+                // Only split when there is nothing left for thieves to take
+                if(t.end - t.start >= 2 * g.grain and queues[idx].size == 0)
+                {
+                    auto mid = t.start + (t.end - t.start) / 2;
+                    if(push(idx, {&g, mid, t.end}))
+                    {
+                        t.end = mid;
+                        continue;
+                    }
+                }
+                // Merge the remainder into the last piece so no piece is smaller than the grain
+                auto last = t.end - t.start < 2 * g.grain ? t.end : t.start + g.grain;
+                (*g.f)(t.start, last, tid);
+                t.start = last;
+            }
+        }
+        catch(...)
+        {
+            g.fail(std::current_exception());
+        }
+        g.release_tid(tid);
+        g.finish();
+    }
+
+    // Run the ranges of the loop while waiting for it. Ranges of other loops are left alone, as
+    // this thread may be in the middle of one of them already.
+    void wait(task_group& g, std::size_t idx)
+    {
+        for(;;)
+        {
+            std::size_t seen = 0;
+            {
+                std::lock_guard<std::mutex> lock(g.m);
+                if(g.remaining == 0)
+                    return;
+                seen = g.pushed;
+            }
+            range_task t;
+            if(take(idx, &g, t))
+            {
+                execute(t, idx);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(g.m);
+            g.cv.wait(lock, [&] { return g.remaining == 0 or g.pushed != seen; });
+        }
+    }
+
+    void work(std::size_t idx)
+    {
+        current_worker = {this, idx};
+        for(;;)
+        {
+            range_task t;
+            if(take(idx, nullptr, t))
+            {
+                execute(t, idx);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(m);
+            cv.wait(lock, [&] { return stop or pending > 0; });
+            if(stop)
+                return;
+        }
+    }
+};
+
+thread_pool::thread_pool(std::size_t n, bool pin_threads)
+    : impl(std::make_unique<thread_pool_impl>(std::max<std::size_t>(n, 1)))
+{
+    for(std::size_t i = 1; i < impl->queues.size(); i++)
+    {
+        impl->workers.emplace_back([this, i, pin_threads] {
+            if(pin_threads)
+                pin_thread(i);
+            impl->work(i);
+        });
+    }
+}
+
+thread_pool::~thread_pool() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(impl->m);
+        impl->stop = true;
+    }
+    impl->cv.notify_all();
+    for(auto& t : impl->workers)
+        t.join();
+}
+
+std::size_t thread_pool::size() const { return impl->workers.size() + 1; }
+
+void thread_pool::run_ranges(std::size_t n, std::size_t grain, const range_function& f) const
+{
+    if(n == 0)
+        return;
+    grain = std::max({grain, n / (ranges_per_thread * size()), std::size_t{1}});
+    if(n < 2 * grain or impl->workers.empty())
+    {
+        f(0, n, 0);
+        return;
+    }
+    task_group g{f, grain, size()};
+    auto idx = impl->current_index();
+    impl->execute({&g, 0, n}, idx);
+    impl->wait(g, idx);
+    if(g.error != nullptr)
+        std::rethrow_exception(g.error);
+}
+
+thread_pool& thread_pool::global()
+{
+    static thread_pool pool{
+        value_of(MIGRAPHX_NUM_THREADS{}, std::max(1u, std::thread::hardware_concurrency())),
+        enabled(MIGRAPHX_PIN_THREADS{})};
+    return pool;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
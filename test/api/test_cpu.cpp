@@ -1,5 +1,8 @@
 #include <migraphx/migraphx.h>
 #include <migraphx/migraphx.hpp>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
 #include "test.hpp"
 
 TEST_CASE(load_and_run)
@@ -22,6 +25,42 @@ TEST_CASE(load_and_run)
     CHECK(bool{shapes_before.front() == outputs.front().get_shape()});
 }
 
+TEST_CASE(load_and_trace)
+{
+    std::string filename = "migraphx_api_trace.json";
+    auto p               = migraphx::parse_onnx("conv_relu_maxpool_test.onnx");
+    p.compile(migraphx::target("ref"));
+    migraphx::program_parameters pp;
+    auto param_shapes = p.get_parameter_shapes();
+    for(auto&& name : param_shapes.names())
+    {
+        pp.add(name, migraphx::argument::generate(param_shapes[name]));
+    }
+    p.trace(pp, filename.c_str());
+    std::ifstream is(filename);
+    std::string trace((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    is.close();
+    EXPECT(trace.find("traceEvents") != std::string::npos);
+    std::remove(filename.c_str());
+}
+
+TEST_CASE(trace_bad_file)
+{
+    auto p = migraphx::parse_onnx("conv_relu_maxpool_test.onnx");
+    p.compile(migraphx::target("ref"));
+    migraphx::program_parameters pp;
+    auto param_shapes = p.get_parameter_shapes();
+    for(auto&& name : param_shapes.names())
+    {
+        pp.add(name, migraphx::argument::generate(param_shapes[name]));
+    }
+    auto trace = [&](const char* filename) {
+        return migraphx_program_trace(p.get_handle_ptr(), pp.get_handle_ptr(), filename);
+    };
+    EXPECT(trace(nullptr) == migraphx_status_bad_param);
+    EXPECT(trace("missing_dir/migraphx_api_trace.json") == migraphx_status_bad_param);
+}
+
 TEST_CASE(load_and_run_init_list)
 {
     auto p             = migraphx::parse_onnx("conv_relu_maxpool_test.onnx");
@@ -0,0 +1,98 @@
+#include <migraphx/bf16.hpp>
+#include <migraphx/literal.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/serialize.hpp>
+#include <migraphx/ref/target.hpp>
+#include <cmath>
+#include <limits>
+#include "test.hpp"
+
+TEST_CASE(bf16_exact)
+{
+    for(float x : {0.0f, 1.0f, -1.0f, 0.5f, 2.0f, 3.0f, 1.5f, -256.0f, 1.0078125f})
+        EXPECT(float(migraphx::bf16{x}) == x);
+}
+
+TEST_CASE(bf16_bits)
+{
+    EXPECT(migraphx::bf16{1.0f}.data == 0x3f80);
+    EXPECT(migraphx::bf16{-2.0f}.data == 0xc000);
+    EXPECT(float(migraphx::bf16::from_bits(0x4040)) == 3.0f);
+}
+
+TEST_CASE(bf16_round_nearest_even)
+{
+    // The ulp of 1 is 2^-7, so these are halfway between two bf16 values
+    EXPECT(float(migraphx::bf16{1.0f + std::ldexp(1.0f, -8)}) == 1.0f);
+    EXPECT(float(migraphx::bf16{1.0f + 3 * std::ldexp(1.0f, -8)}) == 1.0f + std::ldexp(1.0f, -6));
+    // Anything above the halfway point rounds up
+    EXPECT(float(migraphx::bf16{1.0f + std::ldexp(1.0f, -8) + std::ldexp(1.0f, -20)}) ==
+           1.0f + std::ldexp(1.0f, -7));
+}
+
+TEST_CASE(bf16_special)
+{
+    auto inf = std::numeric_limits<float>::infinity();
+    EXPECT(float(migraphx::bf16{inf}) == inf);
+    EXPECT(float(migraphx::bf16{-inf}) == -inf);
+    EXPECT(std::isnan(float(migraphx::bf16{std::numeric_limits<float>::quiet_NaN()})));
+    // The low bits of a nan are dropped, so it must stay a nan instead of becoming infinity
+    EXPECT(std::isnan(float(migraphx::bf16{std::numeric_limits<float>::signaling_NaN()})));
+    EXPECT(float(migraphx::bf16{std::numeric_limits<float>::max()}) == inf);
+}
+
+TEST_CASE(bf16_limits)
+{
+    using limits = std::numeric_limits<migraphx::bf16>;
+    EXPECT(float(limits::max()) == 0x1.fep127f);
+    EXPECT(float(limits::lowest()) == -0x1.fep127f);
+    EXPECT(float(limits::min()) == std::numeric_limits<float>::min());
+    EXPECT(float(limits::epsilon()) == std::ldexp(1.0f, -7));
+    EXPECT(float(limits::infinity()) == std::numeric_limits<float>::infinity());
+    EXPECT(std::isnan(float(limits::quiet_NaN())));
+}
+
+TEST_CASE(bf16_shape)
+{
+    migraphx::shape s{migraphx::shape::bf16_type, {2, 3}};
+    EXPECT(s.type_size() == 2);
+    EXPECT(s.bytes() == 12);
+    EXPECT(migraphx::shape::parse_type("bf16") == migraphx::shape::bf16_type);
+    EXPECT(migraphx::shape::get_type<migraphx::bf16>{} == migraphx::shape::bf16_type);
+}
+
+TEST_CASE(bf16_literal_serialize)
+{
+    migraphx::literal l{{migraphx::shape::bf16_type, {4}}, {1.0f, -2.5f, 0.125f, 3.0f}};
+    auto v  = migraphx::to_value(l);
+    auto l2 = migraphx::from_value<migraphx::literal>(v);
+    EXPECT(l == l2);
+    std::vector<float> result;
+    l2.visit([&](auto x) { result.assign(x.begin(), x.end()); });
+    EXPECT(result == std::vector<float>{1.0f, -2.5f, 0.125f, 3.0f});
+}
+
+TEST_CASE(bf16_convert)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    auto l = mm->add_literal(migraphx::literal{s, {1.0f, 1.00390625f, -3.3f, 100.0f}});
+    auto b = mm->add_instruction(
+        migraphx::make_op("convert",
+                          {{"target_type", migraphx::to_value(migraphx::shape::bf16_type)}}),
+        l);
+    mm->add_instruction(
+        migraphx::make_op("convert",
+                          {{"target_type", migraphx::to_value(migraphx::shape::float_type)}}),
+        b);
+    p.compile(migraphx::ref::target{});
+    auto result = p.eval({}).back();
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    std::vector<float> gold = {1.0f, 1.0f, -3.296875f, 100.0f};
+    EXPECT(results_vector == gold);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,246 @@
+#include <migraphx/program.hpp>
+#include <migraphx/ref/target.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/propagate_constant.hpp>
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/filesystem.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/tmp_dir.hpp>
+#include <cstdlib>
+#include <set>
+#include "test.hpp"
+
+// Folds the constants before lowering to ref, so compiling the program takes a while
+struct folding_target
+{
+    std::string name() const { return "compile_cache_folding"; }
+    std::vector<migraphx::pass> get_passes(migraphx::context& ctx,
+                                           const migraphx::compile_options& options) const
+    {
+        std::vector<migraphx::pass> passes = {migraphx::propagate_constant{},
+                                              migraphx::dead_code_elimination{}};
+        auto ref_passes = migraphx::ref::target{}.get_passes(ctx, options);
+        passes.insert(passes.end(), ref_passes.begin(), ref_passes.end());
+        return passes;
+    }
+    migraphx::context get_context() const { return migraphx::ref::target{}.get_context(); }
+};
+
+// A target for a device that is identified by the context, like the architecture of a gpu
+struct device_target
+{
+    struct context
+    {
+        std::string device{};
+        migraphx::value to_value() const { return {{"device", device}}; }
+        void from_value(const migraphx::value& v) { device = v.at("device").to<std::string>(); }
+        void finish() const {}
+    };
+    std::string device{};
+    std::string name() const { return "compile_cache_device"; }
+    std::vector<migraphx::pass> get_passes(migraphx::context& ctx,
+                                           const migraphx::compile_options& options) const
+    {
+        return migraphx::ref::target{}.get_passes(ctx, options);
+    }
+    migraphx::context get_context() const { return context{device}; }
+};
+
+std::set<std::string> cached_files()
+{
+    std::set<std::string> result;
+    migraphx::fs::path dir = std::getenv("MIGRAPHX_COMPILE_CACHE_DIR");
+    for(const auto& entry : migraphx::fs::directory_iterator(dir))
+        result.insert(entry.path().string());
+    return result;
+}
+
+std::string new_cached_file(const std::set<std::string>& before)
+{
+    auto after = cached_files();
+    for(const auto& f : before)
+        after.erase(f);
+    if(after.size() != 1)
+        return "";
+    return *after.begin();
+}
+
+migraphx::program create_program(float x)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {4, 4}};
+    auto a   = mm->add_parameter("a", s);
+    auto b   = mm->add_literal(migraphx::literal{s, std::vector<float>(s.elements(), x)});
+    auto add = mm->add_instruction(migraphx::make_op("add"), a, b);
+    mm->add_return({add});
+    return p;
+}
+
+std::vector<float> run(const migraphx::program& p)
+{
+    migraphx::parameter_map m;
+    for(auto&& x : p.get_parameter_shapes())
+        m[x.first] = migraphx::generate_argument(x.second, 1);
+    std::vector<float> result;
+    p.eval(m).back().visit([&](auto v) { result.assign(v.begin(), v.end()); });
+    return result;
+}
+
+TEST_CASE(cache_hit)
+{
+    auto before = cached_files();
+    auto p1     = create_program(1);
+    p1.compile(migraphx::ref::target{});
+    auto file = new_cached_file(before);
+    EXPECT(not file.empty());
+
+    auto p2 = create_program(1);
+    p2.compile(migraphx::ref::target{});
+    EXPECT(new_cached_file(before) == file);
+    EXPECT(p2.is_compiled());
+    EXPECT(p1.sort() == p2.sort());
+    EXPECT(run(p1) == run(p2));
+}
+
+TEST_CASE(cache_key)
+{
+    auto before = cached_files();
+    auto p1     = create_program(2);
+    p1.compile(migraphx::ref::target{});
+    auto file1 = new_cached_file(before);
+    EXPECT(not file1.empty());
+
+    before = cached_files();
+    auto p2 = create_program(3);
+    p2.compile(migraphx::ref::target{});
+    auto file2 = new_cached_file(before);
+    EXPECT(not file2.empty());
+
+    before = cached_files();
+    auto p3 = create_program(2);
+    migraphx::compile_options options;
+    options.fast_math = false;
+    p3.compile(migraphx::ref::target{}, options);
+    auto file3 = new_cached_file(before);
+    EXPECT(not file3.empty());
+
+    before = cached_files();
+    auto p4 = create_program(2);
+    p4.compile(folding_target{});
+    auto file4 = new_cached_file(before);
+    EXPECT(not file4.empty());
+    EXPECT(run(p1) != run(p2));
+    EXPECT(run(p1) == run(p4));
+}
+
+TEST_CASE(cache_key_device)
+{
+    auto before = cached_files();
+    auto p1     = create_program(5);
+    p1.compile(device_target{"gfx1"});
+    auto file1 = new_cached_file(before);
+    EXPECT(not file1.empty());
+
+    before = cached_files();
+    auto p2 = create_program(5);
+    p2.compile(device_target{"gfx2"});
+    auto file2 = new_cached_file(before);
+    EXPECT(not file2.empty());
+}
+
+TEST_CASE(cache_key_env)
+{
+    auto before = cached_files();
+    auto p1     = create_program(6);
+    p1.compile(migraphx::ref::target{});
+    auto file1 = new_cached_file(before);
+    EXPECT(not file1.empty());
+
+    before = cached_files();
+    setenv("MIGRAPHX_DISABLE_POINTWISE_FUSION", "1", 1); // NOLINT
+    auto p2 = create_program(6);
+    p2.compile(migraphx::ref::target{});
+    unsetenv("MIGRAPHX_DISABLE_POINTWISE_FUSION"); // NOLINT
+    auto file2 = new_cached_file(before);
+    EXPECT(not file2.empty());
+
+    // Tracing does not change the compiled program
+    before = cached_files();
+    setenv("MIGRAPHX_TRACE_EVAL", "1", 1); // NOLINT
+    auto p3 = create_program(6);
+    p3.compile(migraphx::ref::target{});
+    unsetenv("MIGRAPHX_TRACE_EVAL"); // NOLINT
+    EXPECT(new_cached_file(before).empty());
+}
+
+TEST_CASE(cache_hit_module)
+{
+    auto p1 = create_program(7);
+    p1.compile(migraphx::ref::target{});
+
+    auto p2  = create_program(7);
+    auto* mm = p2.get_main_module();
+    p2.compile(migraphx::ref::target{});
+    // The module is loaded in place, so the pointer to it is still valid
+    EXPECT(mm == p2.get_main_module());
+    EXPECT(p1.sort() == p2.sort());
+    EXPECT(mm->size() == p1.get_main_module()->size());
+    EXPECT(run(p1) == run(p2));
+}
+
+TEST_CASE(cache_invalid_file)
+{
+    auto before = cached_files();
+    auto p1     = create_program(4);
+    p1.compile(migraphx::ref::target{});
+    auto file = new_cached_file(before);
+    EXPECT(not file.empty());
+    migraphx::write_buffer(file, std::vector<char>(16, 'x'));
+
+    auto p2 = create_program(4);
+    p2.compile(migraphx::ref::target{});
+    EXPECT(p1.sort() == p2.sort());
+    EXPECT(run(p1) == run(p2));
+    EXPECT(migraphx::read_buffer(file).size() > 16);
+}
+
+TEST_CASE(cache_hit_folded)
+{
+    auto create = [] {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        migraphx::shape s{migraphx::shape::float_type, {128, 128}};
+        auto x   = mm->add_parameter("x", s);
+        auto w   = mm->add_literal(migraphx::generate_literal(s, 1));
+        for(int i = 0; i < 4; i++)
+        {
+            auto c = mm->add_literal(migraphx::generate_literal(s, i + 2));
+            w      = mm->add_instruction(migraphx::make_op("dot"), w, c);
+        }
+        auto dot = mm->add_instruction(migraphx::make_op("dot"), x, w);
+        mm->add_return({dot});
+        return p;
+    };
+    auto before = cached_files();
+    auto p1     = create();
+    p1.compile(folding_target{});
+    auto file = new_cached_file(before);
+    EXPECT(not file.empty());
+
+    auto p2 = create();
+    p2.compile(folding_target{});
+    EXPECT(new_cached_file(before) == file);
+    EXPECT(p1.sort() == p2.sort());
+}
+
+int main(int argc, const char* argv[])
+{
+    migraphx::register_target(folding_target{});
+    migraphx::register_target(device_target{});
+    migraphx::tmp_dir td{"compile_cache"};
+    setenv("MIGRAPHX_COMPILE_CACHE_DIR", td.path.string().c_str(), 1); // NOLINT
+    test::run(argc, argv);
+}
@@ -0,0 +1,74 @@
+#include <migraphx/ref/target.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/verify.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+#include <test.hpp>
+
+static migraphx::program create_program(std::size_t sequence_length, bool masked)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {2, 4, sequence_length, 16}};
+    auto q      = mm->add_parameter("q", s);
+    auto k      = mm->add_parameter("k", s);
+    auto v      = mm->add_parameter("v", s);
+    auto kt     = mm->add_instruction(
+        migraphx::make_op("transpose", {{"permutation", {0, 1, 3, 2}}}), k);
+    auto scores = mm->add_instruction(migraphx::make_op("dot"), q, kt);
+    auto scale  = mm->add_instruction(
+        migraphx::make_op("multibroadcast", {{"out_lens", scores->get_shape().lens()}}),
+        mm->add_literal(migraphx::literal{migraphx::shape{migraphx::shape::float_type}, {4.0f}}));
+    scores = mm->add_instruction(migraphx::make_op("div"), scores, scale);
+    if(masked)
+    {
+        migraphx::shape ms{migraphx::shape::float_type, {2, 1, 1, sequence_length}};
+        auto mask = mm->add_instruction(
+            migraphx::make_op("multibroadcast", {{"out_lens", scores->get_shape().lens()}}),
+            mm->add_parameter("mask", ms));
+        scores = mm->add_instruction(migraphx::make_op("add"), scores, mask);
+    }
+    auto probabilities = mm->add_instruction(migraphx::make_op("softmax", {{"axis", 3}}), scores);
+    mm->add_instruction(migraphx::make_op("dot"), probabilities, v);
+    return p;
+}
+
+static std::vector<float> run(migraphx::program p, const migraphx::parameter_map& m)
+{
+    std::vector<float> result;
+    p.eval(m).back().visit([&](auto output) { result.assign(output.begin(), output.end()); });
+    return result;
+}
+
+static void check_attention(std::size_t sequence_length, bool masked)
+{
+    auto p = create_program(sequence_length, masked);
+    p.compile(migraphx::make_target("cpu"));
+    auto* mm = p.get_main_module();
+    EXPECT(std::any_of(
+        mm->begin(), mm->end(), [](auto&& ins) { return ins.name() == "cpu::attention"; }));
+    auto ref = create_program(sequence_length, masked);
+    ref.compile(migraphx::ref::target{});
+
+    migraphx::parameter_map m;
+    unsigned long seed = 0;
+    for(auto&& x : ref.get_parameter_shapes())
+        m[x.first] = migraphx::generate_argument(x.second, seed++);
+    EXPECT(migraphx::verify_range(run(p, m), run(ref, m)));
+}
+
+// The key blocks of the kernel hold 64 keys, so the longer sequences have partial blocks
+TEST_CASE(attention_short) { check_attention(7, false); }
+
+TEST_CASE(attention_masked) { check_attention(130, true); }
+
+int main(int argc, const char* argv[])
+{
+    setenv("MIGRAPHX_ENABLE_CPU_ATTENTION", "1", 1); // NOLINT
+    test::run(argc, argv);
+}
@@ -0,0 +1,78 @@
+#include <migraphx/cpu/compile_pointwise.hpp>
+#include <migraphx/cpu/host_isa.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/verify.hpp>
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include <test.hpp>
+
+static std::vector<migraphx::shape> input_shapes()
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    return {s, s, s};
+}
+
+static migraphx::operation create_op()
+{
+    migraphx::module m;
+    auto x = m.add_parameter("x0", migraphx::shape{migraphx::shape::float_type});
+    auto y = m.add_parameter("x1", migraphx::shape{migraphx::shape::float_type});
+    auto z = m.add_instruction(migraphx::make_op("add"), x, y);
+    m.add_return({z});
+    auto inputs = input_shapes();
+    return migraphx::cpu::compile_pointwise(migraphx::cpu::generate_pointwise(inputs, m), inputs);
+}
+
+// Serialize the op as if it was saved on a host with another instruction set
+static migraphx::operation from_other_host(const migraphx::operation& op)
+{
+    auto v   = op.to_value();
+    v["isa"] = "other";
+    return migraphx::make_op(op.name(), v);
+}
+
+TEST_CASE(pointwise_records_isa)
+{
+    auto op = create_op();
+    EXPECT(op.to_value().at("isa").to<std::string>() == migraphx::cpu::host_isa());
+}
+
+TEST_CASE(pointwise_recompiles_for_host)
+{
+    auto op     = from_other_host(create_op());
+    auto inputs = input_shapes();
+    auto ctx    = migraphx::make_target("cpu").get_context();
+    op.finalize(ctx, inputs.back(), inputs);
+    EXPECT(op.to_value().at("isa").to<std::string>() == migraphx::cpu::host_isa());
+
+    auto x      = migraphx::generate_argument(inputs[0], 0);
+    auto y      = migraphx::generate_argument(inputs[1], 1);
+    auto output = migraphx::generate_argument(inputs[2], 2);
+    auto result = op.compute(ctx, inputs.back(), {x, y, output});
+    std::vector<float> xs;
+    std::vector<float> ys;
+    std::vector<float> zs;
+    x.visit([&](auto v) { xs.assign(v.begin(), v.end()); });
+    y.visit([&](auto v) { ys.assign(v.begin(), v.end()); });
+    result.visit([&](auto v) { zs.assign(v.begin(), v.end()); });
+    std::vector<float> gold(xs.size());
+    std::transform(xs.begin(), xs.end(), ys.begin(), gold.begin(), std::plus<>{});
+    EXPECT(migraphx::verify_range(zs, gold));
+}
+
+TEST_CASE(pointwise_other_host_without_source)
+{
+    auto v      = from_other_host(create_op()).to_value();
+    v["src"]    = "";
+    auto op     = migraphx::make_op("cpu::pointwise", v);
+    auto inputs = input_shapes();
+    auto ctx    = migraphx::make_target("cpu").get_context();
+    EXPECT(test::throws([&] { op.finalize(ctx, inputs.back(), inputs); }));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
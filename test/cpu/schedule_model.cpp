@@ -0,0 +1,124 @@
+#include <migraphx/cpu/schedule_model.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/schedule.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <algorithm>
+#include <unordered_map>
+#include <test.hpp>
+
+static std::size_t get_stream(migraphx::instruction_ref ins)
+{
+    return ins->get_operator().to_value().at("stream").to<std::size_t>();
+}
+
+static std::size_t get_event(migraphx::instruction_ref ins)
+{
+    return ins->get_operator().to_value().at("event").to<std::size_t>();
+}
+
+TEST_CASE(concurrency)
+{
+    migraphx::cpu::schedule_model model{3};
+    EXPECT(model.concurrency() == 3);
+}
+
+TEST_CASE(weights)
+{
+    migraphx::cpu::schedule_model model{2};
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    EXPECT(model.weight(migraphx::make_op("cpu::allocate", {{"shape", migraphx::to_value(s)}})) ==
+           0);
+    EXPECT(model.weight(migraphx::make_op("add")) == 2);
+}
+
+TEST_CASE(sched)
+{
+    migraphx::cpu::schedule_model model{2};
+    migraphx::module m;
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    auto x  = m.add_parameter("x", s);
+    auto a1 = m.add_instruction(migraphx::make_op("abs"), x);
+    auto a2 = m.add_instruction(migraphx::make_op("neg"), a1);
+    auto b  = m.add_instruction(migraphx::make_op("relu"), x);
+    model.sched(m, a1, 1);
+    model.sched(m, a2, 1);
+    model.sched(m, b, 0);
+
+    EXPECT(a1->name() == "cpu::launch");
+    EXPECT(a2->name() == "cpu::launch");
+    EXPECT(b->name() == "cpu::launch");
+    auto s1 = std::prev(a1);
+    EXPECT(s1->name() == "cpu::set_stream");
+    EXPECT(get_stream(s1) == 1);
+    // The stream is already set for the second instruction
+    EXPECT(bool{std::prev(a2) == a1});
+    auto s0 = std::prev(b);
+    EXPECT(s0->name() == "cpu::set_stream");
+    EXPECT(get_stream(s0) == 0);
+}
+
+TEST_CASE(record_wait)
+{
+    migraphx::cpu::schedule_model model{2};
+    migraphx::module m;
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    auto x = m.add_parameter("x", s);
+    auto a = m.add_instruction(migraphx::make_op("abs"), x);
+    auto b = m.add_instruction(migraphx::make_op("neg"), a);
+    model.record(m, a, 3);
+    model.wait(m, b, 3);
+
+    auto record = std::next(a);
+    EXPECT(record->name() == "cpu::record_event");
+    EXPECT(get_event(record) == 3);
+    auto wait = std::prev(b);
+    EXPECT(wait->name() == "cpu::wait_event");
+    EXPECT(get_event(wait) == 3);
+}
+
+TEST_CASE(schedule_branches)
+{
+    migraphx::module m;
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    auto x  = m.add_parameter("x", s);
+    auto a1 = m.add_instruction(migraphx::make_op("abs"), x);
+    auto a2 = m.add_instruction(migraphx::make_op("neg"), a1);
+    auto b1 = m.add_instruction(migraphx::make_op("relu"), x);
+    auto b2 = m.add_instruction(migraphx::make_op("tanh"), b1);
+    auto c  = m.add_instruction(migraphx::make_op("add"), a2, b2);
+    m.add_return({c});
+    migraphx::run_passes(m, {migraphx::schedule{migraphx::cpu::schedule_model{2}}});
+
+    std::size_t stream = 0;
+    std::unordered_map<migraphx::instruction_ref, std::size_t> ins2stream;
+    for(auto ins : migraphx::iterator_for(m))
+    {
+        if(ins->name() == "cpu::set_stream")
+            stream = get_stream(ins);
+        else if(ins->name() == "cpu::launch")
+            ins2stream[ins] = stream;
+    }
+    EXPECT(ins2stream.at(a1) == ins2stream.at(a2));
+    EXPECT(ins2stream.at(b1) == ins2stream.at(b2));
+    EXPECT(ins2stream.at(a1) != ins2stream.at(b1));
+    // The merge waits for the branch on the other stream
+    EXPECT(std::any_of(
+        m.begin(), m.end(), [](auto&& ins) { return ins.name() == "cpu::record_event"; }));
+    EXPECT(std::any_of(
+        m.begin(), m.end(), [](auto&& ins) { return ins.name() == "cpu::wait_event"; }));
+}
+
+TEST_CASE(set_stream_finalize)
+{
+    migraphx::context ctx = migraphx::cpu::context{};
+    auto op               = migraphx::make_op("cpu::set_stream", {{"stream", 2}});
+    op.finalize(ctx, {}, {});
+    // The stream is created but the main thread stays current
+    EXPECT(migraphx::any_cast<migraphx::cpu::context>(ctx).get_stream_id() == 0);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,113 @@
+#include <migraphx/ref/target.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/verify.hpp>
+#include <cstdlib>
+#include <vector>
+#include <test.hpp>
+
+static migraphx::shape input_shape() { return {migraphx::shape::float_type, {1, 8, 16, 16}}; }
+
+// Two independent branches of convolutions that the schedule pass puts on different streams
+static migraphx::program create_program()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape ws{migraphx::shape::float_type, {8, 8, 3, 3}};
+    auto x      = mm->add_parameter("x", input_shape());
+    auto branch = [&](unsigned long seed) {
+        auto w1   = mm->add_literal(migraphx::generate_literal(ws, seed));
+        auto w2   = mm->add_literal(migraphx::generate_literal(ws, seed + 1));
+        auto conv = migraphx::make_op("convolution", {{"padding", {1, 1}}});
+        auto c1   = mm->add_instruction(conv, x, w1);
+        auto r1   = mm->add_instruction(migraphx::make_op("relu"), c1);
+        auto c2   = mm->add_instruction(conv, r1, w2);
+        return mm->add_instruction(migraphx::make_op("tanh"), c2);
+    };
+    auto a = branch(0);
+    auto b = branch(2);
+    mm->add_instruction(migraphx::make_op("add"), a, b);
+    return p;
+}
+
+static std::vector<float> run(migraphx::program p, const migraphx::parameter_map& m)
+{
+    std::vector<float> result;
+    p.eval(m).back().visit([&](auto output) { result.assign(output.begin(), output.end()); });
+    return result;
+}
+
+static std::size_t get_stream(migraphx::instruction_ref ins)
+{
+    return ins->get_operator().to_value().at("stream").to<std::size_t>();
+}
+
+static std::pair<std::size_t, std::size_t> get_interval(migraphx::instruction_ref ins)
+{
+    auto alias  = migraphx::instruction::get_output_alias(ins);
+    auto offset = alias->get_operator().to_value().at("offset").to<std::size_t>();
+    return {offset, offset + alias->get_shape().bytes()};
+}
+
+static bool is_overlap(std::pair<std::size_t, std::size_t> x, std::pair<std::size_t, std::size_t> y)
+{
+    return std::max(x.first, y.first) < std::min(x.second, y.second);
+}
+
+TEST_CASE(streams_match_ref)
+{
+    auto p = create_program();
+    p.compile(migraphx::make_target("cpu"));
+    auto ref = create_program();
+    ref.compile(migraphx::ref::target{});
+
+    migraphx::parameter_map m;
+    m["x"]    = migraphx::generate_argument(input_shape(), 1);
+    auto gold = run(ref, m);
+    EXPECT(migraphx::verify_range(run(p, m), gold));
+    // The streams are reused by the next evaluation
+    EXPECT(migraphx::verify_range(run(p, m), gold));
+}
+
+TEST_CASE(streams_keep_buffers_apart)
+{
+    auto p = create_program();
+    p.compile(migraphx::make_target("cpu"));
+    auto* mm = p.get_main_module();
+    EXPECT(std::any_of(mm->begin(), mm->end(), [](auto&& ins) {
+        return ins.name() == "cpu::set_stream" and
+               ins.get_operator().to_value().at("stream").template to<std::size_t>() > 0;
+    }));
+
+    // Work queued on another stream can still be running when the main thread computes an
+    // instruction, so their buffers can not be shared until the streams are joined
+    std::size_t stream = 0;
+    std::vector<migraphx::instruction_ref> queued;
+    for(auto ins : migraphx::iterator_for(*mm))
+    {
+        if(ins->name() == "cpu::wait_event")
+            break;
+        if(ins->name() == "cpu::set_stream")
+            stream = get_stream(ins);
+        if(ins->name() != "cpu::launch" or
+           migraphx::instruction::get_output_alias(ins)->name() != "load")
+            continue;
+        if(stream != 0)
+        {
+            queued.push_back(ins);
+            continue;
+        }
+        for(auto q : queued)
+            EXPECT(not is_overlap(get_interval(q), get_interval(ins)));
+    }
+}
+
+int main(int argc, const char* argv[])
+{
+    setenv("MIGRAPHX_CPU_STREAMS", "2", 1); // NOLINT
+    test::run(argc, argv);
+}
@@ -1,6 +1,7 @@
 #include <migraphx/eliminate_common_subexpression.hpp>
 #include <migraphx/pass_manager.hpp>
 #include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/instruction.hpp>
 #include <basic_ops.hpp>
 #include <migraphx/make_op.hpp>
 
@@ -203,4 +204,59 @@ TEST_CASE(cse_test_submodule)
     EXPECT(p == create_program(true));
 }
 
+TEST_CASE(cse_attributes)
+{
+    migraphx::module m1;
+    {
+        auto x  = m1.add_parameter("x", {migraphx::shape::float_type, {4}});
+        auto s1 = m1.add_instruction(
+            migraphx::make_op("slice", {{"axes", {0}}, {"starts", {0}}, {"ends", {2}}}), x);
+        auto s2 = m1.add_instruction(
+            migraphx::make_op("slice", {{"axes", {0}}, {"starts", {2}}, {"ends", {4}}}), x);
+        auto s3 = m1.add_instruction(
+            migraphx::make_op("slice", {{"axes", {0}}, {"starts", {0}}, {"ends", {2}}}), x);
+        auto sum1 = m1.add_instruction(migraphx::make_op("add"), s1, s2);
+        auto sum2 = m1.add_instruction(migraphx::make_op("add"), s3, s2);
+        m1.add_instruction(pass_op{}, sum1, sum2);
+    }
+    run_pass(m1);
+
+    migraphx::module m2;
+    {
+        auto x  = m2.add_parameter("x", {migraphx::shape::float_type, {4}});
+        auto s1 = m2.add_instruction(
+            migraphx::make_op("slice", {{"axes", {0}}, {"starts", {0}}, {"ends", {2}}}), x);
+        auto s2 = m2.add_instruction(
+            migraphx::make_op("slice", {{"axes", {0}}, {"starts", {2}}, {"ends", {4}}}), x);
+        auto sum1 = m2.add_instruction(migraphx::make_op("add"), s1, s2);
+        m2.add_instruction(pass_op{}, sum1, sum1);
+    }
+    EXPECT(m1 == m2);
+}
+
+TEST_CASE(cse_large)
+{
+    // Over 100k instructions with the same name, which should not take quadratic time
+    const std::size_t n = 35000;
+    migraphx::module m;
+    auto sum = m.add_literal(1);
+    for(std::size_t i = 0; i < n; i++)
+    {
+        auto x = m.add_instruction(migraphx::make_op("add"), sum, sum);
+        auto y = m.add_instruction(migraphx::make_op("add"), sum, sum);
+        sum    = m.add_instruction(migraphx::make_op("add"), x, y);
+    }
+    m.add_instruction(pass_op{}, sum);
+    // Apply the pass directly, since validating the module after each pass is quadratic
+    migraphx::eliminate_common_subexpression{}.apply(m);
+
+    auto is_add = [](const auto& ins) {
+        return ins.name() == "add" and not ins.outputs().empty();
+    };
+    EXPECT(std::count_if(m.begin(), m.end(), is_add) == 2 * n);
+    EXPECT(std::all_of(m.begin(), m.end(), [&](const auto& ins) {
+        return not is_add(ins) or ins.inputs().front() == ins.inputs().back();
+    }));
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
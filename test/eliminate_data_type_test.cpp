@@ -7,11 +7,14 @@
 
 #include <test.hpp>
 
-void run_pass(migraphx::module& m, std::set<migraphx::shape::type_t> types)
+void run_pass(migraphx::module& m,
+              std::set<migraphx::shape::type_t> types,
+              std::set<std::string> supported_ops = {})
 {
     migraphx::run_passes(
         m,
-        {migraphx::eliminate_data_type{std::move(types), migraphx::shape::float_type},
+        {migraphx::eliminate_data_type{
+             std::move(types), migraphx::shape::float_type, std::move(supported_ops)},
          migraphx::eliminate_identity{},
          migraphx::dead_code_elimination{}});
 }
@@ -68,4 +71,30 @@ TEST_CASE(quant)
     EXPECT(mm1 == mm2);
 }
 
+TEST_CASE(quant_supported)
+{
+    migraphx::shape s{migraphx::shape::int8_type, {2, 2}};
+    migraphx::module mm1;
+    {
+        auto x   = mm1.add_parameter("x", s);
+        auto y   = mm1.add_parameter("y", s);
+        auto dot = mm1.add_instruction(migraphx::make_op("quant_dot"), x, y);
+        mm1.add_instruction(migraphx::make_op("abs"), dot);
+    }
+    run_pass(mm1, {migraphx::shape::int8_type, migraphx::shape::int32_type}, {"quant_dot"});
+
+    migraphx::module mm2;
+    {
+        auto x      = mm2.add_parameter("x", s);
+        auto y      = mm2.add_parameter("y", s);
+        auto dot    = mm2.add_instruction(migraphx::make_op("quant_dot"), x, y);
+        auto floatd = mm2.add_instruction(
+            migraphx::make_op("convert", {{"target_type", migraphx::shape::float_type}}), dot);
+        auto abs = mm2.add_instruction(migraphx::make_op("abs"), floatd);
+        mm2.add_instruction(
+            migraphx::make_op("convert", {{"target_type", migraphx::shape::int32_type}}), abs);
+    }
+    EXPECT(mm1 == mm2);
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
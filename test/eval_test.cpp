@@ -4,6 +4,7 @@
 #include <migraphx/instruction.hpp>
 #include <migraphx/stringutils.hpp>
 #include <migraphx/compile_options.hpp>
+#include <migraphx/pass_manager.hpp>
 #include <sstream>
 #include "test.hpp"
 #include <basic_ops.hpp>
@@ -105,6 +106,23 @@ struct invert_pass
     }
 };
 
+// Uses the second argument of the binary ops for both arguments, without going through the module
+struct repeat_arg_pass
+{
+    std::string name() const { return "repeat_arg_pass"; }
+
+    void apply(migraphx::module& m) const
+    {
+        for(auto ins : migraphx::iterator_for(m))
+        {
+            if(ins->inputs().size() != 2)
+                continue;
+            migraphx::instruction::replace_argument(
+                ins, ins->inputs().front(), ins->inputs().back());
+        }
+    }
+};
+
 struct invert_target
 {
     std::string name() const { return "invert"; }
@@ -153,6 +171,67 @@ TEST_CASE(literal_test2)
     EXPECT(result != migraphx::literal{3});
 }
 
+TEST_CASE(literal_test_modified)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto one = mm->add_literal(1);
+    auto two = mm->add_literal(2);
+    auto sum = mm->add_instruction(sum_op{}, one, two);
+    EXPECT(p.eval({}).back() == migraphx::literal{3});
+
+    // The cached execution plan must not be reused once the module changes
+    mm->add_instruction(sum_op{}, sum, two);
+    EXPECT(p.eval({}).back() == migraphx::literal{5});
+}
+
+TEST_CASE(literal_test_replaced)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto one = mm->add_literal(1);
+    auto two = mm->add_literal(2);
+    auto sum = mm->add_instruction(sum_op{}, one, two);
+    p.compile(id_target{});
+    EXPECT(p.eval({}).back() == migraphx::literal{3});
+
+    // The plan must be rebuilt even though the number of instructions is the same
+    mm->replace_instruction(sum, minus_op{}, two, one);
+    EXPECT(p.eval({}).back() == migraphx::literal{1});
+}
+
+TEST_CASE(literal_test_pass_after_eval)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto one = mm->add_literal(1);
+    auto two = mm->add_literal(2);
+    mm->add_instruction(minus_op{}, two, one);
+    p.compile(id_target{});
+    EXPECT(p.eval({}).back() == migraphx::literal{1});
+
+    migraphx::run_passes(p, {repeat_arg_pass{}});
+    EXPECT(p.eval({}).back() == migraphx::literal{0});
+}
+
+TEST_CASE(param_test_repeat)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::int32_type});
+    auto y   = mm->add_parameter("y", {migraphx::shape::int32_type});
+    mm->add_instruction(sum_op{}, x, y);
+    p.compile(id_target{});
+
+    for(int i = 0; i < 3; i++)
+    {
+        auto result = p.eval({{"x", migraphx::literal{i}.get_argument()},
+                              {"y", migraphx::literal{2}.get_argument()}})
+                          .back();
+        EXPECT(result == migraphx::literal{i + 2});
+    }
+}
+
 TEST_CASE(print_test)
 {
     migraphx::program p;
@@ -0,0 +1,140 @@
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/check_shapes.hpp>
+#include <memory>
+#include <thread>
+#include "test.hpp"
+
+struct session_target
+{
+    struct context
+    {
+        void finish() const {}
+    };
+    std::string name() const { return "session_test"; }
+    std::vector<migraphx::pass> get_passes(migraphx::context&,
+                                           const migraphx::compile_options&) const
+    {
+        return {};
+    }
+    migraphx::context get_context() const { return context{}; }
+};
+
+// Copies its input through a buffer that is only allocated during finalize, like the
+// preallocated scratch memory of the cpu target. Sharing the buffer between concurrent
+// evaluations would corrupt the result.
+struct scratch_copy_op
+{
+    std::shared_ptr<std::vector<float>> buffer = nullptr;
+
+    template <class Self, class F>
+    static auto reflect(Self&, F)
+    {
+        return migraphx::pack();
+    }
+
+    std::string name() const { return "scratch_copy_op"; }
+    migraphx::shape compute_shape(const std::vector<migraphx::shape>& inputs) const
+    {
+        migraphx::check_shapes{inputs, *this}.has(1);
+        return inputs.front();
+    }
+    void finalize(session_target::context&,
+                  const migraphx::shape& s,
+                  const std::vector<migraphx::shape>&)
+    {
+        buffer = std::make_shared<std::vector<float>>(s.elements());
+    }
+    migraphx::argument compute(const migraphx::shape& s,
+                               const std::vector<migraphx::argument>& args) const
+    {
+        args.front().visit([&](auto input) {
+            for(std::size_t i = 0; i < input.size(); i++)
+            {
+                (*buffer)[i] = input[i];
+                std::this_thread::yield();
+            }
+        });
+        migraphx::argument result{s};
+        result.visit([&](auto output) { std::copy(buffer->begin(), buffer->end(), output.begin()); });
+        return result;
+    }
+};
+
+static migraphx::program create_program()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {2, 8}};
+    auto x   = mm->add_parameter("x", s);
+    auto y   = mm->add_parameter("y", s);
+    auto sum = mm->add_instruction(migraphx::make_op("add"), x, y);
+    auto cp  = mm->add_instruction(scratch_copy_op{}, sum);
+    mm->add_instruction(migraphx::make_op("relu"), cp);
+    migraphx::register_target(session_target{});
+    p.compile(session_target{});
+    return p;
+}
+
+static migraphx::parameter_map create_params(const migraphx::program& p, unsigned long seed)
+{
+    migraphx::parameter_map m;
+    for(auto&& x : p.get_parameter_shapes())
+        m[x.first] = migraphx::generate_argument(x.second, seed++);
+    return m;
+}
+
+TEST_CASE(session_eval)
+{
+    auto p       = create_program();
+    auto params  = create_params(p, 0);
+    auto gold    = p.eval(params).back();
+    auto session = migraphx::execution_session{p};
+    for(int i = 0; i < 3; i++)
+    {
+        auto result = session.eval(params).back();
+        EXPECT(result == gold);
+    }
+}
+
+TEST_CASE(session_own_context)
+{
+    auto p = create_program();
+    migraphx::execution_session session1{p};
+    migraphx::execution_session session2{p};
+    EXPECT(not is_shared(session1.get_context(), p.get_context()));
+    EXPECT(not is_shared(session1.get_context(), session2.get_context()));
+}
+
+TEST_CASE(session_concurrent_eval)
+{
+    const std::size_t nthreads = 4;
+    const std::size_t iters    = 16;
+    auto p                     = create_program();
+    std::vector<migraphx::parameter_map> params;
+    std::vector<migraphx::argument> gold;
+    for(std::size_t i = 0; i < nthreads; i++)
+    {
+        params.push_back(create_params(p, i * 2));
+        gold.push_back(p.eval(params.back()).back());
+    }
+
+    std::vector<int> passed(nthreads, 0);
+    std::vector<std::thread> threads;
+    for(std::size_t i = 0; i < nthreads; i++)
+    {
+        threads.emplace_back([&, i] {
+            migraphx::execution_session session{p};
+            for(std::size_t j = 0; j < iters; j++)
+                passed[i] += session.eval(params[i]).back() == gold[i] ? 1 : 0;
+        });
+    }
+    for(auto& t : threads)
+        t.join();
+    EXPECT(std::all_of(passed.begin(), passed.end(), [&](int x) { return x == iters; }));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
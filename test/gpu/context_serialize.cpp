@@ -10,7 +10,7 @@ TEST_CASE(gpu_context_serialize)
     migraphx::context ctx = migraphx::gpu::context{0, 3};
 
     auto v = ctx.to_value();
-    EXPECT(v.size() == 2);
+    EXPECT(v.size() == 3);
 
     EXPECT(v.contains("events"));
     EXPECT(v.at("events").without_key().to<std::size_t>() == 0);
@@ -18,6 +18,9 @@ TEST_CASE(gpu_context_serialize)
     EXPECT(v.contains("streams"));
     EXPECT(v.at("streams").without_key().to<std::size_t>() == 3);
 
+    EXPECT(v.contains("arch"));
+    EXPECT(not v.at("arch").without_key().to<std::string>().empty());
+
     migraphx::gpu::context g_ctx;
     g_ctx.from_value(v);
 
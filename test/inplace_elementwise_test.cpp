@@ -0,0 +1,170 @@
+#include <migraphx/inplace_elementwise.hpp>
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/check_shapes.hpp>
+#include <migraphx/instruction.hpp>
+#include <basic_ops.hpp>
+#include <test.hpp>
+
+struct allocate
+{
+    migraphx::shape s{};
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::pack(f(self.s, "shape"));
+    }
+
+    std::string name() const { return "allocate"; }
+    migraphx::shape compute_shape(const std::vector<migraphx::shape>& inputs) const
+    {
+        migraphx::check_shapes{inputs, *this}.has(0);
+        return s;
+    }
+};
+
+struct test_allocation_model
+{
+    std::string name() const { return "allocate"; }
+    std::string copy() const { return "copy"; }
+    migraphx::operation allocate(const migraphx::shape& s) const { return ::allocate{s}; }
+    migraphx::operation preallocate(const migraphx::shape& s, const std::string&) const
+    {
+        return ::allocate{s};
+    }
+};
+
+template <bool Inplace>
+struct elementwise_op
+{
+    std::string name() const { return Inplace ? "inplace_op" : "elementwise_op"; }
+    migraphx::value attributes() const { return {{"inplace", Inplace}}; }
+    migraphx::shape compute_shape(const std::vector<migraphx::shape>& inputs) const
+    {
+        migraphx::check_shapes{inputs, *this}.has(2, 3);
+        return inputs.back();
+    }
+    std::ptrdiff_t output_alias(const std::vector<migraphx::shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+
+using inplace_op = elementwise_op<true>;
+
+void run_pass(migraphx::module& m)
+{
+    migraphx::run_passes(m,
+                         {migraphx::inplace_elementwise{test_allocation_model{}},
+                          migraphx::dead_code_elimination{}});
+}
+
+migraphx::instruction_ref add_alloc(migraphx::module& m, const migraphx::shape& s)
+{
+    return m.add_instruction(allocate{s});
+}
+
+std::size_t count_allocate(const migraphx::module& m)
+{
+    return std::count_if(m.begin(), m.end(), [](auto&& ins) { return ins.name() == "allocate"; });
+}
+
+TEST_CASE(inplace_chain)
+{
+    migraphx::module m;
+
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    auto x  = m.add_parameter("x", s);
+    auto a1 = add_alloc(m, s);
+    auto e1 = m.add_instruction(inplace_op{}, x, a1);
+    auto a2 = add_alloc(m, s);
+    auto e2 = m.add_instruction(inplace_op{}, e1, a2);
+    auto a3 = add_alloc(m, s);
+    auto e3 = m.add_instruction(inplace_op{}, e2, x, a3);
+    m.add_return({e3});
+    run_pass(m);
+
+    // The parameter is not overwritten
+    EXPECT(bool{e1->inputs() == std::vector<migraphx::instruction_ref>{x, a1}});
+    EXPECT(bool{e2->inputs() == std::vector<migraphx::instruction_ref>{e1, e1}});
+    EXPECT(bool{e3->inputs() == std::vector<migraphx::instruction_ref>{e2, x, e2}});
+    EXPECT(count_allocate(m) == 1);
+}
+
+TEST_CASE(inplace_used_later)
+{
+    migraphx::module m;
+
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    auto x  = m.add_parameter("x", s);
+    auto a1 = add_alloc(m, s);
+    auto e1 = m.add_instruction(inplace_op{}, x, a1);
+    auto a2 = add_alloc(m, s);
+    auto e2 = m.add_instruction(inplace_op{}, e1, a2);
+    auto a3 = add_alloc(m, s);
+    auto e3 = m.add_instruction(inplace_op{}, e2, e1, a3);
+    m.add_return({e3});
+    run_pass(m);
+
+    // The first result is still read after the second one is computed
+    EXPECT(bool{e2->inputs() == std::vector<migraphx::instruction_ref>{e1, a2}});
+    EXPECT(bool{e3->inputs() == std::vector<migraphx::instruction_ref>{e2, e1, e2}});
+    EXPECT(count_allocate(m) == 2);
+}
+
+TEST_CASE(inplace_alias)
+{
+    migraphx::module m;
+
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    auto x  = m.add_parameter("x", s);
+    auto a1 = add_alloc(m, s);
+    auto e1 = m.add_instruction(inplace_op{}, x, a1);
+    auto p1 = m.add_instruction(pass_op{}, e1);
+    auto a2 = add_alloc(m, s);
+    auto e2 = m.add_instruction(inplace_op{}, p1, a2);
+    m.add_return({e2, e1});
+    run_pass(m);
+
+    // The buffer is returned through another alias
+    EXPECT(bool{e2->inputs() == std::vector<migraphx::instruction_ref>{p1, a2}});
+    EXPECT(count_allocate(m) == 2);
+}
+
+TEST_CASE(inplace_different_shape)
+{
+    migraphx::module m;
+
+    migraphx::shape s1{migraphx::shape::float_type, {2, 3}};
+    migraphx::shape s2{migraphx::shape::float_type, {2, 3}, {1, 2}};
+    auto x  = m.add_parameter("x", s1);
+    auto a1 = add_alloc(m, s2);
+    auto e1 = m.add_instruction(inplace_op{}, x, a1);
+    auto a2 = add_alloc(m, s1);
+    auto e2 = m.add_instruction(inplace_op{}, e1, a2);
+    m.add_return({e2});
+    run_pass(m);
+
+    EXPECT(bool{e2->inputs() == std::vector<migraphx::instruction_ref>{e1, a2}});
+    EXPECT(count_allocate(m) == 2);
+}
+
+TEST_CASE(not_inplace)
+{
+    migraphx::module m;
+
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    auto x  = m.add_parameter("x", s);
+    auto a1 = add_alloc(m, s);
+    auto e1 = m.add_instruction(inplace_op{}, x, a1);
+    auto a2 = add_alloc(m, s);
+    auto e2 = m.add_instruction(elementwise_op<false>{}, e1, a2);
+    m.add_return({e2});
+    run_pass(m);
+
+    EXPECT(bool{e2->inputs() == std::vector<migraphx::instruction_ref>{e1, a2}});
+    EXPECT(count_allocate(m) == 2);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
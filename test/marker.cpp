@@ -3,8 +3,12 @@
 #include <migraphx/ranges.hpp>
 #include <migraphx/make_op.hpp>
 #include <migraphx/marker.hpp>
+#include <migraphx/marker_trace.hpp>
+#include <migraphx/json.hpp>
 #include <migraphx/instruction.hpp>
 
+#include <sstream>
+
 #include "test.hpp"
 
 struct mock_marker
@@ -54,4 +58,37 @@ TEST_CASE(marker)
     EXPECT(migraphx::contains(output, "Mock marker program stop."));
 }
 
+TEST_CASE(marker_trace)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+
+    auto one = mm->add_literal(1);
+    auto two = mm->add_literal(2);
+    mm->add_instruction(migraphx::make_op("add"), one, two);
+    p.compile(migraphx::ref::target{});
+
+    std::stringstream ss;
+    p.mark({}, migraphx::create_marker_trace(ss));
+
+    auto trace  = migraphx::from_json_string(ss.str());
+    auto events = trace.at("traceEvents");
+    // One event for each instruction and one for the program
+    EXPECT(events.size() == p.get_main_module()->size() + 1);
+    EXPECT(std::all_of(events.begin(), events.end(), [](const auto& event) {
+        return event.at("ph").template to<std::string>() == "X" and
+               event.at("dur").template to<double>() >= 0;
+    }));
+    auto program_event = events.at(events.size() - 1);
+    EXPECT(program_event.at("name").to<std::string>() == "program");
+    auto add = std::find_if(events.begin(), events.end(), [](const auto& event) {
+        return event.at("name").template to<std::string>() == "ref::op";
+    });
+    EXPECT(add != events.end());
+    EXPECT(add->at("args").at("bytes").to<std::size_t>() == 4);
+    EXPECT(add->at("args").at("inputs").size() == 2);
+    EXPECT(add->at("args").at("instruction").to<std::string>() == "main:@2");
+    EXPECT(add->at("ts").to<double>() >= program_event.at("ts").to<double>());
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -1063,4 +1063,68 @@ TEST_CASE(match_finder)
     match::find_matches(mm, match_find_sum{sum}, match_find_literal{sum});
 }
 
+TEST_CASE(match_root_names)
+{
+    using names = std::unordered_set<std::string>;
+    EXPECT(match::get_root_names(match::name("sum")) == names{"sum"});
+    EXPECT(match::get_root_names(match::name("sum", "pass")) == names{"sum", "pass"});
+    EXPECT(match::get_root_names(match::name("sum")(match::standard_shape()).bind("x")) ==
+           names{"sum"});
+    EXPECT(match::get_root_names(match::all_of(match::standard_shape(), match::name("sum"))) ==
+           names{"sum"});
+    EXPECT(match::get_root_names(match::any_of(match::name("sum"), match::name("pass"))) ==
+           names{"sum", "pass"});
+    EXPECT(match::get_root_names(match::any_matcher{match::name("sum")}) == names{"sum"});
+    EXPECT(match::get_root_names(match::standard_shape()).empty());
+    EXPECT(match::get_root_names(match::any_of(match::name("sum"), match::standard_shape()))
+               .empty());
+    EXPECT(match::get_root_names(match::none_of(match::name("sum"))).empty());
+    EXPECT(match::get_root_names(match::skip_broadcasts(match::name("sum"))).empty());
+}
+
+struct match_find_count
+{
+    std::string name;
+    std::vector<std::string>* matched;
+    auto matcher() const
+    {
+        return match::all_of(match::any_of(match::name(name), match::name("pass")),
+                             match::standard_shape());
+    }
+
+    void apply(migraphx::module&, const match::matcher_result& r) const
+    {
+        matched->push_back(name + ":" + r.result->name());
+    }
+};
+
+struct match_find_any
+{
+    std::vector<std::string>* matched;
+    auto matcher() const { return match::standard_shape(); }
+
+    void apply(migraphx::module&, const match::matcher_result& r) const
+    {
+        matched->push_back("any:" + r.result->name());
+    }
+};
+
+TEST_CASE(match_finder_order)
+{
+    migraphx::module mm;
+    auto one = mm.add_literal(1);
+    auto two = mm.add_literal(2);
+    auto sum = mm.add_instruction(sum_op{}, one, two);
+    mm.add_instruction(pass_op{}, sum);
+    std::vector<std::string> matched;
+    // Only the first finder that matches is applied, even when the finders that can match any
+    // operator are listed between the ones that are indexed by name
+    match::find_matches(mm,
+                        match_find_count{"sum", &matched},
+                        match_find_any{&matched},
+                        match_find_count{"@literal", &matched});
+    std::vector<std::string> expected = {"any:@literal", "any:@literal", "sum:sum", "sum:pass"};
+    EXPECT(matched == expected);
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
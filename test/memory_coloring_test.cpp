@@ -12,6 +12,11 @@ void run_pass(migraphx::module& m)
     migraphx::run_passes(m, {migraphx::memory_coloring{"allocate", true}});
 }
 
+void run_packing_pass(migraphx::module& m)
+{
+    migraphx::run_passes(m, {migraphx::memory_coloring{"allocate", true, true}});
+}
+
 struct allocate
 {
     migraphx::shape s{};
@@ -3767,4 +3772,71 @@ TEST_CASE(literal_test)
     CHECK(lit == result);
 }
 
+TEST_CASE(packing1)
+{
+    migraphx::module m;
+
+    auto a1 = add_alloc(m, {migraphx::shape::float_type, {8}});
+    auto m1 = m.add_instruction(pass_op{}, a1);
+    auto m2 = add_alloc(m, {migraphx::shape::float_type, {40}});
+    auto p3 = add_alloc(m, {migraphx::shape::float_type, {40}});
+    m.add_instruction(pass_op{}, p3, m2, m1);
+    run_packing_pass(m);
+    CHECK(m.get_parameter_shape("scratch").bytes() == 352);
+    CHECK(no_allocate(m));
+    CHECK(is_disjoint({a1, m2, p3}));
+}
+
+TEST_CASE(packing2)
+{
+    migraphx::module m;
+
+    auto a1 = add_alloc(m, {migraphx::shape::float_type, {40}});
+    auto m1 = m.add_instruction(pass_op{}, a1);
+    auto a2 = add_alloc(m, {migraphx::shape::float_type, {8}});
+    auto m2 = m.add_instruction(pass_op{}, a2, m1);
+    auto a3 = add_alloc(m, {migraphx::shape::float_type, {32}});
+    m.add_instruction(pass_op{}, a3, m2);
+    run_packing_pass(m);
+    // The last allocation reuses the space of the first one, so only the peak live bytes are used
+    CHECK(m.get_parameter_shape("scratch").bytes() == 192);
+    CHECK(no_allocate(m));
+    CHECK(is_disjoint({a1, a2}));
+    CHECK(is_disjoint({a2, a3}));
+}
+
+TEST_CASE(packing_alignment)
+{
+    migraphx::module m;
+
+    auto a1 = add_alloc(m, {migraphx::shape::int8_type, {3}});
+    auto m1 = m.add_instruction(pass_op{}, a1);
+    auto a2 = add_alloc(m, {migraphx::shape::int8_type, {3}});
+    m.add_instruction(pass_op{}, a2, m1);
+    run_packing_pass(m);
+    // The second allocation starts at the default alignment of 32 bytes
+    CHECK(m.get_parameter_shape("scratch").bytes() == 36);
+    CHECK(no_allocate(m));
+    CHECK(is_disjoint({a1, a2}));
+}
+
+TEST_CASE(packing_large)
+{
+    // Over 100k instructions, where each allocation is live with the one before it
+    const std::size_t n = 50000;
+    migraphx::module m;
+
+    auto x = m.add_parameter("x", {migraphx::shape::float_type, {8}});
+    for(std::size_t i = 0; i < n; i++)
+    {
+        auto a = add_alloc(m, {migraphx::shape::float_type, {8}});
+        x      = m.add_instruction(pass_op{}, a, x);
+    }
+    m.add_instruction(pass_op{}, x);
+    // Apply the pass directly, since validating the module after each pass is quadratic
+    migraphx::memory_coloring{"allocate", true, true}.apply(m);
+    CHECK(m.get_parameter_shape("scratch").bytes() == 64);
+    CHECK(no_allocate(m));
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
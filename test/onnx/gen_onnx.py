@@ -1456,6 +1456,35 @@ def expand_test():
     return ([shape_const, node], [x], [y])
 
 
+@onnx_test
+def external_data_offset_test():
+    w = np.arange(1, 7).astype(np.float32).reshape(2, 3)
+    b = np.arange(7, 10).astype(np.float32)
+    # Both tensors share one file, b is not aligned to its type
+    with open('external_data_offset_test.weight', 'wb') as f:
+        f.write(bytes(14))
+        f.write(b.tobytes())
+        f.write(bytes(64 - 26))
+        f.write(w.tobytes())
+
+    w_tensor = onnx.numpy_helper.from_array(w, 'w')
+    b_tensor = onnx.numpy_helper.from_array(b, 'b')
+    for t, offset in [(w_tensor, 64), (b_tensor, 14)]:
+        length = len(t.raw_data)
+        t.ClearField('raw_data')
+        onnx.external_data_helper.set_external_data(
+            t, 'external_data_offset_test.weight', offset, length)
+        t.data_location = TensorProto.EXTERNAL
+
+    x = helper.make_tensor_value_info('x', TensorProto.FLOAT, [2, 3])
+    y = helper.make_tensor_value_info('y', TensorProto.FLOAT, [2, 3])
+
+    mul = onnx.helper.make_node('Mul', inputs=['x', 'w'], outputs=['mul'])
+    add = onnx.helper.make_node('Add', inputs=['mul', 'b'], outputs=['y'])
+
+    return ([mul, add], [x], [y], [w_tensor, b_tensor])
+
+
 @onnx_test
 def eyelike_default_test():
     T1 = helper.make_tensor_value_info('T1', TensorProto.FLOAT, [3, 4])
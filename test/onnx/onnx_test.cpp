@@ -1356,6 +1356,24 @@ TEST_CASE(external_data_diff_path_test)
     EXPECT(p == prog);
 }
 
+TEST_CASE(external_data_offset_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto w   = mm->add_literal(
+        migraphx::literal{{migraphx::shape::float_type, {2, 3}}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}});
+    auto b =
+        mm->add_literal(migraphx::literal{{migraphx::shape::float_type, {3}}, {7.0f, 8.0f, 9.0f}});
+    auto x   = mm->add_parameter("x", migraphx::shape{migraphx::shape::float_type, {2, 3}});
+    auto mul = mm->add_instruction(migraphx::make_op("mul"), x, w);
+    auto bb =
+        mm->add_instruction(migraphx::make_op("multibroadcast", {{"out_lens", {2, 3}}}), b);
+    mm->add_instruction(migraphx::make_op("add"), mul, bb);
+
+    auto prog = optimize_onnx("external_data_offset_test.onnx");
+    EXPECT(p == prog);
+}
+
 TEST_CASE(eyelike_default_test)
 {
     migraphx::program p;
@@ -0,0 +1,143 @@
+#include <migraphx/par_for.hpp>
+#include <migraphx/thread_pool.hpp>
+#include <atomic>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include "test.hpp"
+
+TEST_CASE(par_for_visit_once)
+{
+    const std::size_t n = 1000;
+    std::vector<std::atomic<int>> visited(n);
+    migraphx::par_for(n, 1, [&](auto i) { visited[i]++; });
+    EXPECT(std::all_of(visited.begin(), visited.end(), [](auto& x) { return x == 1; }));
+}
+
+TEST_CASE(par_for_tid)
+{
+    const std::size_t n          = 1000;
+    const std::size_t threadsize = migraphx::thread_pool::global().size();
+    std::vector<std::atomic<int>> in_use(threadsize);
+    std::atomic<int> shared{0};
+    migraphx::par_for(n, 1, [&](auto, auto tid) {
+        if(tid >= threadsize or in_use[tid]++ != 0)
+            shared++;
+        std::this_thread::yield();
+        if(tid < threadsize)
+            in_use[tid]--;
+    });
+    EXPECT(shared.load() == 0);
+}
+
+TEST_CASE(par_for_nested)
+{
+    const std::size_t n = 64;
+    std::vector<std::atomic<int>> visited(n * n);
+    migraphx::par_for(n, 1, [&](auto i) {
+        migraphx::par_for(n, 1, [&](auto j) { visited[i * n + j]++; });
+    });
+    EXPECT(std::all_of(visited.begin(), visited.end(), [](auto& x) { return x == 1; }));
+}
+
+TEST_CASE(par_for_exception)
+{
+    EXPECT(test::throws<std::runtime_error>([&] {
+        migraphx::par_for(100, 1, [&](auto i) {
+            if(i == 50)
+                throw std::runtime_error("error");
+        });
+    }));
+    // The pool is still usable afterwards
+    std::atomic<int> sum{0};
+    migraphx::par_for(100, 1, [&](auto i) { sum += i; });
+    EXPECT(sum.load() == 4950);
+}
+
+TEST_CASE(thread_pool_ranges)
+{
+    migraphx::thread_pool pool{4};
+    const std::size_t n     = 1000;
+    const std::size_t grain = 16;
+    std::vector<std::atomic<int>> visited(n);
+    std::atomic<int> invalid{0};
+    pool.parallel_for(n, grain, [&](auto start, auto end, auto tid) {
+        if((end - start < grain and end != n) or tid >= pool.size())
+            invalid++;
+        for(auto i = start; i < end; i++)
+            visited[i]++;
+    });
+    EXPECT(pool.size() == 4);
+    EXPECT(invalid.load() == 0);
+    EXPECT(std::all_of(visited.begin(), visited.end(), [](auto& x) { return x == 1; }));
+}
+
+TEST_CASE(thread_pool_nested)
+{
+    // Each level waits on the level below, which would deadlock a pool without enough threads
+    // if waiting threads did not run the inner loops themselves
+    migraphx::thread_pool pool{2};
+    const std::size_t n = 16;
+    std::vector<std::atomic<int>> visited(n * n * n);
+    pool.run(n, [&](auto i) {
+        pool.run(n, [&](auto j) {
+            pool.run(n, [&](auto k) { visited[(i * n + j) * n + k]++; });
+        });
+    });
+    EXPECT(std::all_of(visited.begin(), visited.end(), [](auto& x) { return x == 1; }));
+}
+
+TEST_CASE(thread_pool_concurrent_callers)
+{
+    migraphx::thread_pool pool{4};
+    const std::size_t n = 256;
+    std::vector<std::atomic<int>> visited(4 * n);
+    std::vector<std::thread> threads;
+    for(std::size_t t = 0; t < 4; t++)
+    {
+        threads.emplace_back([&, t] { pool.run(n, [&](auto i) { visited[t * n + i]++; }); });
+    }
+    for(auto& t : threads)
+        t.join();
+    EXPECT(std::all_of(visited.begin(), visited.end(), [](auto& x) { return x == 1; }));
+}
+
+TEST_CASE(thread_pool_pinned)
+{
+    migraphx::thread_pool pool{4, true};
+    std::atomic<int> sum{0};
+    pool.run(4, [&](auto i) { sum += i; });
+    EXPECT(sum.load() == 6);
+}
+
+TEST_CASE(par_for_dispatch_repeat)
+{
+    const std::size_t iters   = 200;
+    const std::size_t threads = migraphx::thread_pool::global().size();
+    std::vector<std::size_t> data(threads);
+    for(std::size_t i = 0; i < iters; i++)
+        migraphx::par_for_impl(threads, threads, [&](auto j) { data[j]++; });
+    EXPECT(std::all_of(data.begin(), data.end(), [&](auto x) { return x == iters; }));
+}
+
+// The cost of an index grows with the index, so the pool has to balance the work
+TEST_CASE(par_for_imbalanced)
+{
+    const std::size_t n = 256;
+    std::vector<double> data(n);
+    auto work = [&](std::size_t i) {
+        double x = 0;
+        for(std::size_t j = 0; j < i * 64; j++)
+            x += std::sqrt(static_cast<double>(j));
+        data[i] = x;
+    };
+    for(std::size_t i = 0; i < n; i++)
+        work(i);
+    auto gold = data;
+    std::fill(data.begin(), data.end(), 0.0);
+    migraphx::par_for(n, 1, work);
+    EXPECT(data == gold);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
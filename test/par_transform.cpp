@@ -0,0 +1,83 @@
+#include <migraphx/par_transform.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/shape_for_each.hpp>
+#include "test.hpp"
+
+template <class F>
+bool check_transform(const migraphx::shape& out_shape,
+                     const migraphx::shape& xs,
+                     const migraphx::shape& ys,
+                     F f)
+{
+    auto x = migraphx::generate_argument(xs, 1);
+    auto y = migraphx::generate_argument(ys, 2);
+    migraphx::argument out{out_shape};
+    auto xv   = x.get<float>();
+    auto yv   = y.get<float>();
+    auto outv = out.get<float>();
+    migraphx::par_transform(outv, f, xv, yv);
+    bool result = true;
+    migraphx::shape_for_each(out_shape, [&](const auto& idx) {
+        auto expected = f(xv(idx.begin(), idx.end()), yv(idx.begin(), idx.end()));
+        if(outv(idx.begin(), idx.end()) != expected)
+            result = false;
+    });
+    return result;
+}
+
+auto add = [](float x, float y) { return x + y; };
+
+TEST_CASE(transform_packed)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3, 4}};
+    EXPECT(check_transform(s, s, s, add));
+}
+
+TEST_CASE(transform_scalar_broadcast)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3, 4}};
+    migraphx::shape bs{migraphx::shape::float_type, {2, 3, 4}, {0, 0, 0}};
+    EXPECT(check_transform(s, s, bs, add));
+    EXPECT(check_transform(s, bs, s, add));
+}
+
+TEST_CASE(transform_inner_broadcast)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3, 4}};
+    migraphx::shape bs{migraphx::shape::float_type, {2, 3, 4}, {0, 1, 0}};
+    EXPECT(check_transform(s, s, bs, add));
+}
+
+TEST_CASE(transform_outer_broadcast)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3, 4}};
+    migraphx::shape bs{migraphx::shape::float_type, {2, 3, 4}, {0, 0, 1}};
+    EXPECT(check_transform(s, bs, s, add));
+}
+
+TEST_CASE(transform_transposed)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3, 4}};
+    migraphx::shape ts{migraphx::shape::float_type, {2, 3, 4}, {12, 1, 3}};
+    migraphx::shape bs{migraphx::shape::float_type, {2, 3, 4}, {1, 0, 2}};
+    EXPECT(check_transform(s, ts, s, add));
+    EXPECT(check_transform(ts, s, bs, add));
+    EXPECT(check_transform(ts, ts, ts, add));
+}
+
+TEST_CASE(transform_long_rows)
+{
+    migraphx::shape s{migraphx::shape::float_type, {3, 10001}};
+    migraphx::shape bs{migraphx::shape::float_type, {3, 10001}, {1, 0}};
+    EXPECT(check_transform(s, s, bs, add));
+    migraphx::shape ps{migraphx::shape::float_type, {100003}};
+    EXPECT(check_transform(ps, ps, ps, add));
+}
+
+TEST_CASE(transform_scalar)
+{
+    migraphx::shape s{migraphx::shape::float_type};
+    EXPECT(check_transform(s, s, s, add));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
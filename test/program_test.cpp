@@ -7,6 +7,11 @@
 #include <migraphx/apply_alpha_beta.hpp>
 #include "test.hpp"
 #include <migraphx/make_op.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/check_shapes.hpp>
+#include <migraphx/memory_coloring.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/preallocate_param.hpp>
 
 #include <basic_ops.hpp>
 
@@ -173,4 +178,205 @@ TEST_CASE(program_copy)
     }
 }
 
+TEST_CASE(program_memory_report)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+
+    migraphx::shape s{migraphx::shape::float_type, {64}};
+    auto x   = mm->add_parameter("x", s);
+    auto one = mm->add_literal(migraphx::generate_literal({migraphx::shape::float_type, {16}}));
+    auto a   = mm->add_instruction(migraphx::make_op("exp"), x);
+    auto b   = mm->add_instruction(migraphx::make_op("relu"), a);
+    auto c   = mm->add_instruction(migraphx::make_op("add"), a, b);
+    mm->add_instruction(pass_op{}, c, one);
+
+    auto report = p.memory_report(2);
+    EXPECT(report.at("literal_bytes").to<std::size_t>() == 64);
+    EXPECT(report.at("scratch_bytes").to<std::size_t>() == 0);
+    auto main = report.at("modules").at(0);
+    EXPECT(main.at("name").to<std::string>() == "main");
+    EXPECT(main.at("literals").to<std::size_t>() == 1);
+    EXPECT(main.at("parameter_bytes").to<std::size_t>() == 256);
+    // The three tensors are live when the second add is computed
+    EXPECT(main.at("peak_bytes").to<std::size_t>() == 768);
+    auto top = main.at("live_at_peak");
+    EXPECT(top.size() == 2);
+    EXPECT(top.at(0).at("instruction").to<std::string>() == "main:@2");
+    EXPECT(top.at(0).at("bytes").to<std::size_t>() == 256);
+}
+
+TEST_CASE(program_memory_report_scratch)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+
+    migraphx::shape s{migraphx::shape::float_type, {64}};
+    auto x       = mm->add_parameter("x", s);
+    auto scratch = mm->add_parameter("scratch", {migraphx::shape::float_type, {192}});
+    auto load    = [&](std::size_t offset) {
+        return mm->add_instruction(
+            migraphx::make_op("load", {{"shape", migraphx::to_value(s)}, {"offset", offset}}),
+            scratch);
+    };
+    auto l1 = load(0);
+    auto p1 = mm->add_instruction(pass_op{}, l1, x);
+    auto l2 = load(512);
+    auto p2 = mm->add_instruction(pass_op{}, l2, p1);
+    auto l3 = load(0);
+    auto p3 = mm->add_instruction(pass_op{}, l3, p2);
+    mm->add_return({p3});
+
+    auto main = p.memory_report().at("modules").at(0);
+    EXPECT(main.at("scratch_bytes").to<std::size_t>() == 768);
+    EXPECT(main.at("parameter_bytes").to<std::size_t>() == 256);
+    EXPECT(main.at("peak_bytes").to<std::size_t>() == 512);
+    auto top = main.at("live_at_peak");
+    EXPECT(top.size() == 2);
+    EXPECT(top.at(0).at("operator").to<std::string>() == "load");
+    EXPECT(top.at(0).at("offset").to<std::size_t>() == 0);
+    EXPECT(top.at(1).at("offset").to<std::size_t>() == 512);
+}
+
+struct test_allocate
+{
+    std::string op_name;
+    migraphx::shape s{};
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::pack(f(self.s, "shape"));
+    }
+
+    std::string name() const { return op_name; }
+    migraphx::shape compute_shape(const std::vector<migraphx::shape>& inputs) const
+    {
+        migraphx::check_shapes{inputs, *this}.has(0);
+        return s;
+    }
+    migraphx::argument compute(migraphx::context&,
+                               const migraphx::shape& output_shape,
+                               const std::vector<migraphx::argument>&) const
+    {
+        return {output_shape};
+    }
+};
+
+struct test_allocation_model
+{
+    std::string name() const { return "allocate"; }
+    std::string copy() const { return "copy"; }
+    migraphx::operation allocate(const migraphx::shape& s) const
+    {
+        return test_allocate{"allocate", s};
+    }
+    migraphx::operation preallocate(const migraphx::shape& s, const std::string&) const
+    {
+        return test_allocate{"test::preallocate", s};
+    }
+};
+
+TEST_CASE(program_memory_report_preallocated)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+
+    migraphx::shape s{migraphx::shape::float_type, {64}};
+    auto x     = mm->add_parameter("x", s);
+    auto alloc = [&] { return mm->add_instruction(test_allocate{"allocate", s}); };
+    auto p1    = mm->add_instruction(pass_op{}, alloc(), x);
+    auto p2    = mm->add_instruction(pass_op{}, alloc(), p1);
+    auto p3    = mm->add_instruction(pass_op{}, alloc(), p2);
+    mm->add_return({p3});
+    migraphx::run_passes(*mm,
+                         {migraphx::memory_coloring{"allocate"},
+                          migraphx::preallocate_param{"scratch", test_allocation_model{}}});
+    EXPECT(std::any_of(mm->begin(), mm->end(), [](const auto& ins) {
+        return ins.name() == "test::preallocate";
+    }));
+
+    auto main = p.memory_report().at("modules").at(0);
+    EXPECT(main.at("scratch_bytes").to<std::size_t>() >= 512);
+    EXPECT(main.at("parameter_bytes").to<std::size_t>() == 256);
+    // Two of the loads are live at once, and the preallocated scratch is not counted on top
+    EXPECT(main.at("peak_bytes").to<std::size_t>() == 512);
+    auto top = main.at("live_at_peak");
+    EXPECT(top.size() == 2);
+    EXPECT(std::all_of(top.begin(), top.end(), [](const auto& tensor) {
+        return tensor.at("operator").template to<std::string>() == "load";
+    }));
+}
+
+// Copies a literal into the memory of the target, like the write_literals passes of the targets
+struct target_literal
+{
+    migraphx::literal l;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::pack(f(self.l, "literal"));
+    }
+
+    std::string name() const { return "test::literal"; }
+    migraphx::value attributes() const { return {{"literal", true}}; }
+    migraphx::shape compute_shape(const std::vector<migraphx::shape>&) const
+    {
+        return l.get_shape();
+    }
+    migraphx::argument compute(migraphx::context&,
+                               const migraphx::shape&,
+                               const std::vector<migraphx::argument>&) const
+    {
+        return l.get_argument();
+    }
+};
+
+struct write_literals_target
+{
+    struct write_literals
+    {
+        std::string name() const { return "write_literals"; }
+        void apply(migraphx::module& m) const
+        {
+            for(auto ins : migraphx::iterator_for(m))
+            {
+                if(ins->name() == "@literal")
+                    m.replace_instruction(ins, target_literal{ins->get_literal()});
+            }
+        }
+    };
+    std::string name() const { return "write_literals"; }
+    std::vector<migraphx::pass> get_passes(migraphx::context&,
+                                           const migraphx::compile_options&) const
+    {
+        return {write_literals{}};
+    }
+    migraphx::context get_context() const { return migraphx::ref::target{}.get_context(); }
+};
+
+TEST_CASE(program_memory_report_compiled)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+
+    migraphx::shape s{migraphx::shape::float_type, {64}};
+    auto x   = mm->add_parameter("x", s);
+    auto one = mm->add_literal(migraphx::generate_literal(s));
+    auto a   = mm->add_instruction(migraphx::make_op("relu"), x);
+    mm->add_instruction(migraphx::make_op("add"), a, one);
+    p.compile(write_literals_target{});
+
+    auto main = p.memory_report().at("modules").at(0);
+    EXPECT(main.at("literals").to<std::size_t>() == 1);
+    EXPECT(main.at("literal_bytes").to<std::size_t>() == 256);
+    // The literal is not a tensor that is computed, so it is not live at the peak
+    EXPECT(main.at("peak_bytes").to<std::size_t>() == 512);
+    auto top = main.at("live_at_peak");
+    EXPECT(std::none_of(top.begin(), top.end(), [](const auto& tensor) {
+        return tensor.at("operator").template to<std::string>() == "test::literal";
+    }));
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -1,4 +1,4 @@
-import migraphx, array, sys
+import migraphx, array, sys, os, json
 
 
 def test_conv_relu():
@@ -53,6 +53,53 @@ def test_add_scalar():
     print(r)
 
 
+def test_bf16():
+    p = migraphx.program()
+    mm = p.get_main_module()
+    s = migraphx.shape(lens=[2, 3], type="bf16")
+    x = mm.add_parameter("x", s)
+    y = mm.add_instruction(migraphx.op("identity"), [x])
+    mm.add_return([y])
+    p.compile(migraphx.get_target("ref"))
+
+    # The bits of 1, 2, -0.5, 0, 3 and -4 in bf16
+    data = [0x3f80, 0x4000, 0xbf00, 0x0000, 0x4040, 0xc080]
+    r = p.run({"x": create_buffer("H", data, [2, 3])})[-1]
+    assert r.get_shape() == s
+    m = memoryview(r)
+    assert m.format == "H"
+    assert m.tolist() == [data[0:3], data[3:6]]
+
+
+def test_trace():
+    p = migraphx.parse_onnx("conv_relu_maxpool_test.onnx")
+    p.compile(migraphx.get_target("ref"))
+    params = {}
+    for key, value in p.get_parameter_shapes().items():
+        params[key] = migraphx.generate_argument(value)
+
+    filename = "migraphx_py_trace.json"
+    p.trace(params, filename)
+    with open(filename) as f:
+        trace = json.load(f)
+    os.remove(filename)
+    assert trace["traceEvents"][-1]["name"] == "program"
+
+
+def test_trace_bad_file():
+    p = migraphx.parse_onnx("conv_relu_maxpool_test.onnx")
+    p.compile(migraphx.get_target("ref"))
+    params = {}
+    for key, value in p.get_parameter_shapes().items():
+        params[key] = migraphx.generate_argument(value)
+
+    try:
+        p.trace(params, "missing_dir/migraphx_py_trace.json")
+    except RuntimeError:
+        return
+    assert False, "trace did not report the bad file"
+
+
 def test_module():
     p = migraphx.parse_onnx("add_scalar_test.onnx")
     mm = p.get_main_module()
@@ -62,5 +109,8 @@ def test_module():
 
 test_conv_relu()
 test_module()
+test_trace()
+test_trace_bad_file()
+test_bf16()
 if sys.version_info >= (3, 0):
     test_add_scalar()
@@ -104,6 +104,36 @@ TEST_CASE(param_add)
     }
 }
 
+TEST_CASE(param_add_bf16)
+{
+    auto create_program = [](bool quantized) {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+        auto convert = [&](auto ins, migraphx::shape::type_t t) {
+            return mm->add_instruction(
+                migraphx::make_op("convert", {{"target_type", migraphx::to_value(t)}}), ins);
+        };
+        auto p1 = mm->add_parameter("x", s);
+        auto p2 = mm->add_parameter("y", s);
+        if(quantized)
+        {
+            p1 = convert(p1, migraphx::shape::bf16_type);
+            p2 = convert(p2, migraphx::shape::bf16_type);
+        }
+        auto sum = mm->add_instruction(migraphx::make_op("add"), p1, p2);
+        if(quantized)
+            convert(sum, migraphx::shape::float_type);
+
+        return p;
+    };
+
+    auto p1 = create_program(false);
+    auto p2 = create_program(true);
+    migraphx::quantize_bf16(p1);
+    EXPECT(p1 == p2);
+}
+
 TEST_CASE(param_add_sub)
 {
     auto create_program_float = [] {
@@ -0,0 +1,177 @@
+#include <migraphx/reduce_peak_memory.hpp>
+#include <migraphx/memory_coloring.hpp>
+#include <migraphx/schedule.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/check_shapes.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include <basic_ops.hpp>
+#include <test.hpp>
+
+void run_pass(migraphx::module& m)
+{
+    migraphx::run_passes(m, {migraphx::reduce_peak_memory{"allocate"}});
+}
+
+struct allocate
+{
+    migraphx::shape s{};
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::pack(f(self.s, "shape"));
+    }
+
+    std::string name() const { return "allocate"; }
+    migraphx::shape compute_shape(const std::vector<migraphx::shape>& inputs) const
+    {
+        migraphx::check_shapes{inputs, *this}.has(0);
+        return s;
+    }
+    migraphx::argument compute(migraphx::context&,
+                               const migraphx::shape& output_shape,
+                               const std::vector<migraphx::argument>&) const
+    {
+        return {output_shape};
+    }
+};
+
+migraphx::instruction_ref add_alloc(migraphx::module& m, const migraphx::shape& s)
+{
+    return m.add_instruction(allocate{s});
+}
+
+bool is_before(const migraphx::module& m, migraphx::instruction_ref x, migraphx::instruction_ref y)
+{
+    return std::distance(m.begin(), x) < std::distance(m.begin(), y);
+}
+
+TEST_CASE(reorder_branches)
+{
+    migraphx::module m;
+
+    migraphx::shape s{migraphx::shape::float_type, {64, 64}};
+    auto x  = m.add_parameter("x", s);
+    auto a1 = m.add_instruction(migraphx::make_op("exp"), x);
+    auto b1 = m.add_instruction(migraphx::make_op("exp"), x);
+    auto a2 = m.add_instruction(migraphx::make_op("reduce_sum", {{"axes", {1}}}), a1);
+    auto b2 = m.add_instruction(migraphx::make_op("reduce_sum", {{"axes", {1}}}), b1);
+    auto c  = m.add_instruction(migraphx::make_op("add"), a2, b2);
+    m.add_return({c});
+    run_pass(m);
+
+    // The first branch is reduced before the second one is computed
+    EXPECT(is_before(m, a2, b1));
+    EXPECT(is_before(m, a1, a2));
+    EXPECT(is_before(m, b1, b2));
+    EXPECT(is_before(m, b2, c));
+    EXPECT(std::prev(m.end())->name() == "@return");
+}
+
+TEST_CASE(reorder_allocations)
+{
+    migraphx::module m;
+
+    migraphx::shape s{migraphx::shape::float_type, {64}};
+    auto x  = m.add_parameter("x", s);
+    auto a1 = add_alloc(m, s);
+    auto p1 = m.add_instruction(pass_op{}, a1, x);
+    auto a2 = add_alloc(m, s);
+    auto p2 = m.add_instruction(pass_op{}, a2, x);
+    auto a3 = add_alloc(m, {migraphx::shape::float_type, {1}});
+    auto p3 = m.add_instruction(pass_op{}, a3, p1);
+    auto a4 = add_alloc(m, {migraphx::shape::float_type, {1}});
+    auto p4 = m.add_instruction(pass_op{}, a4, p2);
+    m.add_return({p3, p4});
+    run_pass(m);
+
+    // The allocations are moved to just before their use
+    EXPECT(bool{std::next(a1) == p1});
+    EXPECT(bool{std::next(a2) == p2});
+    EXPECT(bool{std::next(a3) == p3});
+    EXPECT(bool{std::next(a4) == p4});
+    // The first buffer is released before the second one is allocated
+    EXPECT(is_before(m, p3, a2));
+}
+
+struct serial_schedule_model
+{
+    std::size_t concurrency() const { return 1; }
+    void sched(migraphx::module&, migraphx::instruction_ref, std::size_t) const {}
+    void wait(migraphx::module&, migraphx::instruction_ref, std::size_t) const {}
+    void record(migraphx::module&, migraphx::instruction_ref, std::size_t) const {}
+    std::size_t weight(const migraphx::operation&) const { return 1; }
+};
+
+std::size_t scratch_size(migraphx::module m, bool reduce)
+{
+    migraphx::run_passes(m,
+                         {migraphx::reduce_peak_memory{"allocate", reduce},
+                          migraphx::schedule{serial_schedule_model{}, true, true},
+                          migraphx::memory_coloring{"allocate"}});
+    return m.get_parameter_shape("scratch").bytes();
+}
+
+TEST_CASE(schedule_keeps_peak)
+{
+    migraphx::module m;
+
+    migraphx::shape bs{migraphx::shape::float_type, {64, 64}};
+    migraphx::shape ss{migraphx::shape::float_type, {64}};
+    auto x  = m.add_parameter("x", bs);
+    auto a1 = m.add_instruction(pass_op{}, add_alloc(m, bs), x);
+    auto b1 = m.add_instruction(pass_op{}, add_alloc(m, bs), x);
+    auto a2 = m.add_instruction(pass_op{}, add_alloc(m, ss), a1);
+    auto b2 = m.add_instruction(pass_op{}, add_alloc(m, ss), b1);
+    auto c  = m.add_instruction(pass_op{}, add_alloc(m, ss), a2, b2);
+    m.add_return({c});
+
+    // The lower peak from reordering is still there after scheduling and memory coloring
+    EXPECT(scratch_size(m, true) < scratch_size(m, false));
+}
+
+TEST_CASE(keep_order)
+{
+    auto create_module = [] {
+        migraphx::module m;
+
+        migraphx::shape s{migraphx::shape::float_type, {64}};
+        auto x  = m.add_parameter("x", s);
+        auto a1 = m.add_instruction(migraphx::make_op("exp"), x);
+        auto a2 = m.add_instruction(migraphx::make_op("relu"), a1);
+        auto b1 = m.add_instruction(migraphx::make_op("exp"), x);
+        auto b2 = m.add_instruction(migraphx::make_op("relu"), b1);
+        auto c  = m.add_instruction(migraphx::make_op("add"), a2, b2);
+        m.add_return({c});
+        return m;
+    };
+    // Every order has the same peak, so the module is not changed
+    auto m1 = create_module();
+    run_pass(m1);
+    auto m2 = create_module();
+    EXPECT(m1 == m2);
+}
+
+TEST_CASE(disabled)
+{
+    auto create_module = [] {
+        migraphx::module m;
+
+        migraphx::shape s{migraphx::shape::float_type, {64, 64}};
+        auto x  = m.add_parameter("x", s);
+        auto a1 = m.add_instruction(migraphx::make_op("exp"), x);
+        auto b1 = m.add_instruction(migraphx::make_op("exp"), x);
+        auto a2 = m.add_instruction(migraphx::make_op("reduce_sum", {{"axes", {1}}}), a1);
+        auto b2 = m.add_instruction(migraphx::make_op("reduce_sum", {{"axes", {1}}}), b1);
+        auto c  = m.add_instruction(migraphx::make_op("add"), a2, b2);
+        m.add_return({c});
+        return m;
+    };
+    auto m1 = create_module();
+    migraphx::run_passes(m1, {migraphx::reduce_peak_memory{"allocate", false}});
+    auto m2 = create_module();
+    EXPECT(m1 == m2);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
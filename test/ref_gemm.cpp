@@ -0,0 +1,185 @@
+#include <migraphx/ref/gemm.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/literal.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/verify.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include "test.hpp"
+
+// The gemm the reference target used before, which computes every element of the output from its
+// multi-index
+template <class T, class U>
+void naive_gemm(migraphx::tensor_view<T> c, migraphx::tensor_view<U> a, migraphx::tensor_view<U> b)
+{
+    auto cs    = c.get_shape();
+    auto dim_0 = cs.lens().size() - 2;
+    auto dim_1 = cs.lens().size() - 1;
+    auto k     = a.get_shape().lens()[dim_1];
+    migraphx::par_for(cs.elements(), [&](auto i) {
+        auto c_idx = cs.multi(i);
+        auto a_idx = c_idx;
+        auto b_idx = c_idx;
+        double s   = 0.0;
+        for(std::size_t kk = 0; kk < k; kk++)
+        {
+            a_idx[dim_1] = b_idx[dim_0] = kk;
+            s += a(a_idx.begin(), a_idx.end()) * b(b_idx.begin(), b_idx.end());
+        }
+        c(c_idx.begin(), c_idx.end()) = s;
+    });
+}
+
+migraphx::argument naive_gemm(const migraphx::shape& cs,
+                              const migraphx::argument& a,
+                              const migraphx::argument& b)
+{
+    migraphx::argument c{cs};
+    c.visit([&](auto cv) {
+        migraphx::visit_all(a, b)([&](auto av, auto bv) { naive_gemm(cv, av, bv); });
+    });
+    return c;
+}
+
+migraphx::argument
+migemm(const migraphx::shape& cs, const migraphx::argument& a, const migraphx::argument& b)
+{
+    migraphx::argument c{cs};
+    if(cs.type() == migraphx::shape::int32_type)
+        migraphx::ref::migemm(c, a, b, int32_t{1}, int32_t{0});
+    else
+        migraphx::ref::migemm(c, a, b, 1.0f, 0.0f);
+    return c;
+}
+
+bool check_gemm(const migraphx::shape& cs, const migraphx::shape& as, const migraphx::shape& bs)
+{
+    auto a = migraphx::generate_argument(as, 1);
+    auto b = migraphx::generate_argument(bs, 2);
+    bool result = false;
+    visit_all(naive_gemm(cs, a, b), migemm(cs, a, b))([&](auto expected, auto actual) {
+        result = migraphx::verify_range(actual, expected);
+    });
+    return result;
+}
+
+TEST_CASE(gemm_packed)
+{
+    migraphx::shape as{migraphx::shape::float_type, {37, 19}};
+    migraphx::shape bs{migraphx::shape::float_type, {19, 71}};
+    migraphx::shape cs{migraphx::shape::float_type, {37, 71}};
+    EXPECT(check_gemm(cs, as, bs));
+}
+
+TEST_CASE(gemm_batched)
+{
+    migraphx::shape as{migraphx::shape::float_type, {2, 3, 17, 8}};
+    migraphx::shape bs{migraphx::shape::float_type, {2, 3, 8, 23}};
+    migraphx::shape cs{migraphx::shape::float_type, {2, 3, 17, 23}};
+    EXPECT(check_gemm(cs, as, bs));
+}
+
+TEST_CASE(gemm_batched_transposed)
+{
+    // The matrices and the batch dimensions are transposed
+    migraphx::shape as{migraphx::shape::float_type, {3, 2, 17, 8}, {8, 408, 24, 1}};
+    migraphx::shape bs{migraphx::shape::float_type, {3, 2, 8, 23}, {184, 552, 1, 8}};
+    migraphx::shape cs{migraphx::shape::float_type, {3, 2, 17, 23}};
+    EXPECT(check_gemm(cs, as, bs));
+}
+
+TEST_CASE(gemm_batched_broadcast)
+{
+    migraphx::shape as{migraphx::shape::float_type, {4, 17, 8}, {0, 8, 1}};
+    migraphx::shape bs{migraphx::shape::float_type, {4, 8, 23}, {184, 0, 8}};
+    migraphx::shape cs{migraphx::shape::float_type, {4, 17, 23}};
+    EXPECT(check_gemm(cs, as, bs));
+}
+
+TEST_CASE(gemm_half)
+{
+    migraphx::shape as{migraphx::shape::half_type, {2, 33, 8}};
+    migraphx::shape bs{migraphx::shape::half_type, {2, 8, 70}};
+    migraphx::shape cs{migraphx::shape::half_type, {2, 33, 70}};
+    EXPECT(check_gemm(cs, as, bs));
+}
+
+TEST_CASE(gemm_int8)
+{
+    migraphx::shape as{migraphx::shape::int8_type, {2, 33, 40}};
+    migraphx::shape bs{migraphx::shape::int8_type, {2, 40, 70}, {2800, 1, 40}};
+    migraphx::shape cs{migraphx::shape::int32_type, {2, 33, 70}};
+    EXPECT(check_gemm(cs, as, bs));
+}
+
+TEST_CASE(gemm_int32_beta)
+{
+    migraphx::shape s{migraphx::shape::int32_type, {5, 5}};
+    auto make_arg = [&](int32_t seed) {
+        std::vector<int32_t> data(s.elements());
+        std::iota(data.begin(), data.end(), seed);
+        std::transform(
+            data.begin(), data.end(), data.begin(), [](auto x) { return (x * 7) % 11 - 5; });
+        return migraphx::literal{s, data}.get_argument();
+    };
+    auto a = make_arg(1);
+    auto b = make_arg(2);
+    auto c = make_arg(3);
+    migraphx::argument expected{s};
+    expected.visit([&](auto e) {
+        visit_all(a, b, c)([&](auto av, auto bv, auto cv) {
+            naive_gemm(e, av, bv);
+            std::transform(e.begin(), e.end(), cv.begin(), e.begin(), [](auto x, auto y) {
+                return 2 * x + 3 * y;
+            });
+        });
+    });
+    migraphx::ref::migemm(c, a, b, int32_t{2}, int32_t{3});
+    EXPECT(c == expected);
+}
+
+// Compares the time of the gemm against the per element implementation it replaced
+void benchmark_gemm(const std::string& name,
+                    migraphx::shape::type_t ctype,
+                    migraphx::shape::type_t type,
+                    std::vector<std::size_t> batch,
+                    std::size_t m,
+                    std::size_t n,
+                    std::size_t k)
+{
+    using clock     = std::chrono::steady_clock;
+    const int iters = 3;
+    auto lens       = [&](std::size_t x, std::size_t y) {
+        auto result = batch;
+        result.push_back(x);
+        result.push_back(y);
+        return result;
+    };
+    migraphx::shape cs{ctype, lens(m, n)};
+    auto a = migraphx::generate_argument({type, lens(m, k)}, 1);
+    auto b = migraphx::generate_argument({type, lens(k, n)}, 2);
+    auto time = [&](auto f) {
+        f();
+        auto start = clock::now();
+        for(int i = 0; i < iters; i++)
+            f();
+        std::chrono::duration<double, std::milli> d = clock::now() - start;
+        return d.count() / iters;
+    };
+    auto naive = time([&] { naive_gemm(cs, a, b); });
+    auto fast  = time([&] { migemm(cs, a, b); });
+    std::cout << "gemm " << name << " " << cs << ": naive " << naive << "ms, migemm " << fast
+              << "ms" << std::endl;
+}
+
+TEST_CASE(gemm_benchmark)
+{
+    using migraphx::shape;
+    benchmark_gemm("float", shape::float_type, shape::float_type, {12}, 64, 64, 64);
+    benchmark_gemm("int8", shape::int32_type, shape::int8_type, {12}, 64, 64, 64);
+    benchmark_gemm("half", shape::half_type, shape::half_type, {}, 128, 128, 128);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
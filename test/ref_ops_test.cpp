@@ -850,6 +850,35 @@ TEST_CASE(contiguous_test)
     EXPECT(migraphx::verify_range(results_vector, data));
 }
 
+TEST_CASE(conv2d_group_dilation_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape a_shape{migraphx::shape::float_type, {1, 4, 4, 4}};
+    std::vector<float> a(a_shape.elements());
+    std::iota(a.begin(), a.end(), 0);
+    auto al = mm->add_literal(migraphx::literal{a_shape, a});
+
+    migraphx::shape c_shape{migraphx::shape::float_type, {2, 2, 2, 2}};
+    std::vector<float> c = {-2, -1, 0, 1, 2, -2, -1, 0, 1, 2, -2, -1, 0, 1, 2, -2};
+    auto cl              = mm->add_literal(migraphx::literal{c_shape, c});
+
+    mm->add_instruction(
+        migraphx::make_op("convolution",
+                          {{"padding", {1, 1}}, {"dilation", {2, 2}}, {"group", 2}}),
+        al,
+        cl);
+    p.compile(migraphx::ref::target{});
+    auto result = p.eval({}).back();
+
+    std::vector<float> s = {5,   -14, -14, -22, -26,  -20,  -23,  6,  -34, -32, -35,
+                            2,   -59, -30, -33, 32,   -143, -114, -117, 32,  -40, 24,
+                            25,  66,  -40, 28,  29,   70,   139,  182,  186, 42};
+    std::vector<float> results_vector(32);
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    EXPECT(migraphx::verify_range(results_vector, s));
+}
+
 TEST_CASE(conv2d_padding_stride_test)
 {
     migraphx::program p;
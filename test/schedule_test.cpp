@@ -265,6 +265,25 @@ TEST_CASE(single_entry)
     EXPECT(check_conflicts(m, onem1, onem2));
 }
 
+TEST_CASE(keep_order)
+{
+    scheduler t{};
+    migraphx::module m;
+
+    auto one    = m.add_literal(1);
+    auto onem1  = m.add_instruction(unary_op{}, one);
+    auto onem2  = m.add_instruction(unary_op{}, onem1);
+    auto onem3  = m.add_instruction(unary_op{}, one);
+    auto binary = m.add_instruction(nary_op{}, onem2, onem3);
+    migraphx::run_passes(m, {migraphx::schedule{t.model, true, true}});
+    EXPECT(t.get_stream(onem1) == t.get_stream(onem2));
+    EXPECT(t.get_stream(onem1) != t.get_stream(onem3));
+    // The instructions are only scheduled on streams, not moved
+    EXPECT(std::distance(m.begin(), onem1) < std::distance(m.begin(), onem2));
+    EXPECT(std::distance(m.begin(), onem2) < std::distance(m.begin(), onem3));
+    EXPECT(std::distance(m.begin(), onem3) < std::distance(m.begin(), binary));
+}
+
 TEST_CASE(stream_free)
 {
     scheduler t{};
@@ -1,6 +1,10 @@
 #include <migraphx/program.hpp>
 #include <migraphx/ref/target.hpp>
 #include <migraphx/load_save.hpp>
+#include <migraphx/msgpack.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
 #include "test.hpp"
 #include <migraphx/make_op.hpp>
 
@@ -56,6 +60,69 @@ TEST_CASE(as_file)
     EXPECT(p1.sort() == p2.sort());
 }
 
+migraphx::program create_program_with_literals()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+
+    migraphx::shape s1{migraphx::shape::float_type, {3, 1000}};
+    migraphx::shape s2{migraphx::shape::int8_type, {3}};
+    migraphx::shape s3{migraphx::shape::double_type, {1000}};
+    auto x  = mm->add_parameter("x", s1);
+    auto l1 = mm->add_literal(migraphx::generate_literal(s1, 1));
+    auto l2 = mm->add_literal(migraphx::generate_literal(s2, 2));
+    auto l3 = mm->add_literal(migraphx::generate_literal(s3, 3));
+    auto add = mm->add_instruction(migraphx::make_op("add"), x, l1);
+    mm->add_return({add, l2, l3});
+    return p;
+}
+
+std::vector<migraphx::literal> get_literals(const migraphx::program& p)
+{
+    std::vector<migraphx::literal> result;
+    auto* mm = p.get_main_module();
+    for(auto ins : migraphx::iterator_for(*mm))
+    {
+        if(ins->name() == "@literal")
+            result.push_back(ins->get_literal());
+    }
+    return result;
+}
+
+TEST_CASE(literal_data)
+{
+    std::string filename = "migraphx_program_literals.mxr";
+    migraphx::program p1 = create_program_with_literals();
+    migraphx::save(p1, filename);
+    migraphx::program p2 = migraphx::load(filename);
+    std::remove(filename.c_str());
+    migraphx::program p3 = migraphx::load_buffer(migraphx::save_buffer(p1));
+    EXPECT(p1.sort() == p2.sort());
+    EXPECT(p1.sort() == p3.sort());
+    EXPECT(get_literals(p1) == get_literals(p2));
+    EXPECT(get_literals(p1) == get_literals(p3));
+    for(const auto& l : get_literals(p2))
+        EXPECT(reinterpret_cast<std::uintptr_t>(l.data()) % 64 == 0);
+}
+
+TEST_CASE(literal_data_unpacked)
+{
+    // Programs saved with all the data in the msgpack can still be loaded
+    migraphx::program p1     = create_program_with_literals();
+    std::vector<char> buffer = migraphx::to_msgpack(p1.to_value());
+    migraphx::program p2     = migraphx::load_buffer(buffer);
+    EXPECT(p1.sort() == p2.sort());
+    EXPECT(get_literals(p1) == get_literals(p2));
+}
+
+TEST_CASE(literal_data_truncated)
+{
+    migraphx::program p      = create_program_with_literals();
+    std::vector<char> buffer = migraphx::save_buffer(p);
+    buffer.resize(buffer.size() - 1);
+    EXPECT(test::throws([&] { migraphx::load_buffer(buffer); }));
+}
+
 TEST_CASE(compiled)
 {
     migraphx::program p1 = create_program();
@@ -0,0 +1,106 @@
+#include <migraphx/shape_for_each.hpp>
+#include <migraphx/op/contiguous.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/par_for.hpp>
+#include <chrono>
+#include <iostream>
+#include "test.hpp"
+
+// The shape_for_each used before, which computes every index with divisions
+template <class F>
+void shape_for_each_div(const migraphx::shape& s, F f)
+{
+    std::vector<std::size_t> indices(s.lens().size());
+    migraphx::shape ss{s.type(), s.lens()};
+    for(std::size_t i = 0; i < ss.elements(); i++)
+    {
+        std::transform(ss.strides().begin(),
+                       ss.strides().end(),
+                       ss.lens().begin(),
+                       indices.begin(),
+                       [&](std::size_t stride, std::size_t len) { return (i / stride) % len; });
+        f(indices);
+    }
+}
+
+TEST_CASE(for_each_order)
+{
+    migraphx::shape s{migraphx::shape::float_type, {3, 1, 4, 2}};
+    std::vector<std::vector<std::size_t>> expected;
+    std::vector<std::vector<std::size_t>> actual;
+    shape_for_each_div(s, [&](const auto& idx) { expected.emplace_back(idx.begin(), idx.end()); });
+    migraphx::shape_for_each(s,
+                             [&](const auto& idx) { actual.emplace_back(idx.begin(), idx.end()); });
+    EXPECT(std::equal(actual.begin(), actual.end(), expected.begin(), expected.end()));
+}
+
+TEST_CASE(for_each_scalar)
+{
+    migraphx::shape s{migraphx::shape::float_type};
+    std::size_t n = 0;
+    migraphx::shape_for_each(s, [&](const auto& idx) {
+        EXPECT(idx.size() == 1);
+        EXPECT(idx[0] == 0);
+        n++;
+    });
+    EXPECT(n == 1);
+}
+
+// Compares copying a transposed tensor to a standard one with the different ways of computing
+// the multi-index of each element
+TEST_CASE(for_each_benchmark)
+{
+    using clock     = std::chrono::steady_clock;
+    const int iters = 3;
+    auto time       = [&](auto f) {
+        f();
+        auto start = clock::now();
+        for(int i = 0; i < iters; i++)
+            f();
+        std::chrono::duration<double, std::milli> d = clock::now() - start;
+        return d.count() / iters;
+    };
+    migraphx::shape ts{migraphx::shape::float_type, {64, 64, 64}, {1, 4096, 64}};
+    migraphx::shape os{ts.type(), ts.lens()};
+    auto input = migraphx::generate_argument(ts);
+    auto x     = input.get<float>();
+    auto run   = [&](auto g) {
+        migraphx::argument output{os};
+        auto y = output.get<float>();
+        auto t = time([&] { g(y); });
+        EXPECT(std::equal(y.begin(), y.end(), x.begin(), x.end()));
+        return t;
+    };
+    auto div = run([&](auto y) {
+        shape_for_each_div(ts, [&](const auto& idx) {
+            y(idx.begin(), idx.end()) = x(idx.begin(), idx.end());
+        });
+    });
+    auto odometer = run([&](auto y) {
+        migraphx::shape_for_each(ts, [&](const auto& idx) {
+            y(idx.begin(), idx.end()) = x(idx.begin(), idx.end());
+        });
+    });
+    auto multi = run([&](auto y) {
+        migraphx::par_for(os.elements(), [&](auto i) {
+            auto idx = os.multi(i);
+            y[i]     = x(idx.begin(), idx.end());
+        });
+    });
+    auto multi_index = run([&](auto y) {
+        migraphx::par_for(os.elements(), [&](auto i) {
+            migraphx::multi_index idx{os, i};
+            y[i] = x(idx.begin(), idx.end());
+        });
+    });
+    auto contiguous = run([&](auto y) {
+        auto result = migraphx::op::contiguous{}.compute(os, {input});
+        std::copy(result.get<float>().begin(), result.get<float>().end(), y.begin());
+    });
+    std::cout << "contiguous " << ts << ": shape_for_each with divisions " << div
+              << "ms, shape_for_each " << odometer << "ms, shape::multi " << multi
+              << "ms, multi_index " << multi_index << "ms, op::contiguous " << contiguous << "ms"
+              << std::endl;
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -605,6 +605,7 @@ TEST_CASE(cpp_type_name)
     EXPECT(migraphx::shape::cpp_type(migraphx::shape::int8_type) == "int8_t");
     EXPECT(migraphx::shape::cpp_type(migraphx::shape::float_type) == "float");
     EXPECT(migraphx::shape::cpp_type(migraphx::shape::half_type) == "half");
+    EXPECT(migraphx::shape::cpp_type(migraphx::shape::bf16_type) == "bf16");
     EXPECT(test::throws([&] { migraphx::shape::cpp_type(migraphx::shape::tuple_type); }));
 }
 
@@ -619,4 +620,53 @@ TEST_CASE(test_with_type)
     EXPECT(s.strides() == new_s.strides());
 }
 
+TEST_CASE(test_multi_index)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3, 4}};
+    for(std::size_t i = 0; i < s.elements(); i++)
+    {
+        migraphx::multi_index idx{s, i};
+        auto expected = s.multi(i);
+        EXPECT(std::equal(idx.begin(), idx.end(), expected.begin(), expected.end()));
+        EXPECT(s.index(idx) == i);
+    }
+}
+
+TEST_CASE(test_multi_index_transposed)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3, 4}, {1, 8, 2}};
+    std::vector<std::size_t> expected = {1, 1, 1};
+    migraphx::multi_index idx{s, 17};
+    EXPECT(idx == migraphx::multi_index(expected.begin(), expected.end()));
+    EXPECT(s.index(idx) == 11);
+}
+
+TEST_CASE(test_multi_index_increment)
+{
+    std::vector<std::size_t> lens = {2, 3, 4};
+    migraphx::shape s{migraphx::shape::float_type, lens};
+    migraphx::multi_index idx(lens.size());
+    for(std::size_t i = 1; i < s.elements(); i++)
+    {
+        EXPECT(idx.increment(lens));
+        EXPECT(idx == migraphx::multi_index(s, i));
+    }
+    EXPECT(not idx.increment(lens));
+    EXPECT(idx == migraphx::multi_index(lens.size()));
+}
+
+TEST_CASE(test_multi_index_large)
+{
+    std::vector<std::size_t> lens(migraphx::multi_index::max_inline_size + 2, 2);
+    migraphx::shape s{migraphx::shape::float_type, lens};
+    migraphx::multi_index idx{s, s.elements() - 1};
+    EXPECT(idx.size() == lens.size());
+    EXPECT(std::all_of(idx.begin(), idx.end(), [](auto i) { return i == 1; }));
+    auto copy = idx;
+    EXPECT(copy == idx);
+    EXPECT(not copy.increment(lens));
+    EXPECT(copy != idx);
+    EXPECT(std::all_of(copy.begin(), copy.end(), [](auto i) { return i == 0; }));
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
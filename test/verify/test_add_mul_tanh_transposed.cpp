@@ -0,0 +1,25 @@
+
+#include "verify_program.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+
+struct test_add_mul_tanh_transposed : verify_program<test_add_mul_tanh_transposed>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        auto x   = mm->add_parameter("x", {migraphx::shape::float_type, {2, 5, 4, 3}});
+        auto y   = mm->add_parameter("y", {migraphx::shape::float_type, {5}});
+        auto z   = mm->add_parameter("z", {migraphx::shape::float_type, {2, 3, 5, 4}});
+        auto tx =
+            mm->add_instruction(migraphx::make_op("transpose", {{"permutation", {0, 3, 1, 2}}}), x);
+        auto by = mm->add_instruction(
+            migraphx::make_op("broadcast", {{"axis", 2}, {"out_lens", {2, 3, 5, 4}}}), y);
+        auto add = mm->add_instruction(migraphx::make_op("add"), tx, by);
+        auto mul = mm->add_instruction(migraphx::make_op("mul"), add, z);
+        mm->add_instruction(migraphx::make_op("tanh"), mul);
+        return p;
+    }
+};
@@ -0,0 +1,46 @@
+#include "verify_program.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/instruction.hpp>
+
+// The keys are transposed and the mask is broadcast across the heads and the queries, as in the
+// self attention of a transformer
+template <std::size_t SequenceLength, bool Masked, migraphx::shape::type_t DType>
+struct test_attention : verify_program<test_attention<SequenceLength, Masked, DType>>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        migraphx::shape s{DType, {2, 4, SequenceLength, 16}};
+        auto q      = mm->add_parameter("q", s);
+        auto k      = mm->add_parameter("k", s);
+        auto v      = mm->add_parameter("v", s);
+        auto kt     = mm->add_instruction(
+            migraphx::make_op("transpose", {{"permutation", {0, 1, 3, 2}}}), k);
+        auto scores = mm->add_instruction(migraphx::make_op("dot"), q, kt);
+        auto scale  = mm->add_instruction(
+            migraphx::make_op("multibroadcast", {{"out_lens", scores->get_shape().lens()}}),
+            mm->add_literal(migraphx::literal{migraphx::shape{DType}, {4.0f}}));
+        scores = mm->add_instruction(migraphx::make_op("div"), scores, scale);
+        if(Masked)
+        {
+            migraphx::shape ms{DType, {2, 1, 1, SequenceLength}};
+            auto mask = mm->add_instruction(
+                migraphx::make_op("multibroadcast", {{"out_lens", scores->get_shape().lens()}}),
+                mm->add_parameter("mask", ms));
+            scores = mm->add_instruction(migraphx::make_op("add"), scores, mask);
+        }
+        auto probabilities =
+            mm->add_instruction(migraphx::make_op("softmax", {{"axis", 3}}), scores);
+        mm->add_instruction(migraphx::make_op("dot"), probabilities, v);
+        return p;
+    }
+};
+
+template struct test_attention<7, false, migraphx::shape::float_type>;
+template struct test_attention<7, true, migraphx::shape::float_type>;
+template struct test_attention<130, true, migraphx::shape::float_type>;
+template struct test_attention<384, true, migraphx::shape::float_type>;
+template struct test_attention<64, true, migraphx::shape::half_type>;
@@ -0,0 +1,30 @@
+#include "verify_program.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+
+// The residual is only read by the add, but it aliases a buffer that is read again afterwards, so
+// it can not be summed into the output of the convolution
+struct test_conv_add_aliased : verify_program<test_conv_add_aliased>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        migraphx::shape xs{migraphx::shape::float_type, {2, 4, 5, 5}};
+        migraphx::shape ys{migraphx::shape::float_type, {2, 100}};
+        migraphx::shape ws{migraphx::shape::float_type, {4, 4, 1, 1}};
+        auto x        = mm->add_parameter("x", xs);
+        auto y        = mm->add_parameter("y", ys);
+        auto w        = mm->add_literal(migraphx::generate_literal(ws, 1));
+        auto tanh     = mm->add_instruction(migraphx::make_op("tanh"), y);
+        auto residual =
+            mm->add_instruction(migraphx::make_op("reshape", {{"dims", {2, 4, 5, 5}}}), tanh);
+        auto conv     = mm->add_instruction(migraphx::make_op("convolution"), x, w);
+        auto add      = mm->add_instruction(migraphx::make_op("add"), residual, conv);
+        auto relu     = mm->add_instruction(migraphx::make_op("relu"), add);
+        auto neg      = mm->add_instruction(migraphx::make_op("neg"), tanh);
+        mm->add_return({relu, neg});
+        return p;
+    }
+};
@@ -0,0 +1,30 @@
+#include "verify_program.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+
+// The residual is a temporary that is only read by the add, so it can be summed into the output
+// of the convolution
+template <std::size_t Channels, std::size_t Size>
+struct test_conv_add_relu : verify_program<test_conv_add_relu<Channels, Size>>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        migraphx::shape xs{migraphx::shape::float_type, {2, Channels, Size, Size}};
+        migraphx::shape ws{migraphx::shape::float_type, {Channels, Channels, 1, 1}};
+        auto x        = mm->add_parameter("x", xs);
+        auto y        = mm->add_parameter("y", xs);
+        auto w        = mm->add_literal(migraphx::generate_literal(ws, 1));
+        auto residual = mm->add_instruction(migraphx::make_op("tanh"), y);
+        auto conv     = mm->add_instruction(migraphx::make_op("convolution"), x, w);
+        auto add      = mm->add_instruction(migraphx::make_op("add"), residual, conv);
+        mm->add_instruction(migraphx::make_op("relu"), add);
+        return p;
+    }
+};
+
+template struct test_conv_add_relu<3, 5>;
+template struct test_conv_add_relu<16, 8>;
+template struct test_conv_add_relu<20, 7>;
@@ -0,0 +1,34 @@
+#include "verify_program.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/instruction.hpp>
+
+template <std::size_t Channels, std::size_t Size>
+struct test_conv_bias_relu : verify_program<test_conv_bias_relu<Channels, Size>>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        migraphx::shape xs{migraphx::shape::float_type, {2, 3, Size, Size}};
+        migraphx::shape ws{migraphx::shape::float_type, {Channels, 3, 3, 3}};
+        migraphx::shape bs{migraphx::shape::float_type, {Channels}};
+        auto x    = mm->add_parameter("x", xs);
+        auto w    = mm->add_literal(migraphx::generate_literal(ws, 1));
+        auto b    = mm->add_literal(migraphx::generate_literal(bs, 2));
+        auto conv = mm->add_instruction(
+            migraphx::make_op("convolution", {{"padding", {1, 1}}}), x, w);
+        auto bias = mm->add_instruction(
+            migraphx::make_op("broadcast", {{"axis", 1}, {"out_lens", conv->get_shape().lens()}}),
+            b);
+        auto add = mm->add_instruction(migraphx::make_op("add"), conv, bias);
+        mm->add_instruction(migraphx::make_op("relu"), add);
+        return p;
+    }
+};
+
+template struct test_conv_bias_relu<4, 5>;
+template struct test_conv_bias_relu<16, 8>;
+template struct test_conv_bias_relu<20, 7>;
+template struct test_conv_bias_relu<64, 14>;
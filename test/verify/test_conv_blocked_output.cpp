@@ -0,0 +1,21 @@
+#include "verify_program.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+
+// The convolution would pick a blocked layout for its output, but it is the result of the module,
+// so it must be written in the standard layout
+struct test_conv_blocked_output : verify_program<test_conv_blocked_output>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        migraphx::shape xs{migraphx::shape::float_type, {2, 16, 14, 14}};
+        migraphx::shape ws{migraphx::shape::float_type, {32, 16, 3, 3}};
+        auto x = mm->add_parameter("x", xs);
+        auto w = mm->add_literal(migraphx::generate_literal(ws, 1));
+        mm->add_instruction(migraphx::make_op("convolution", {{"padding", {1, 1}}}), x, w);
+        return p;
+    }
+};
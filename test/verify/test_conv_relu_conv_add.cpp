@@ -0,0 +1,30 @@
+
+#include "verify_program.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+
+// A residual block with constant weights, where the channels are not a multiple of the blocked
+// layouts
+struct test_conv_relu_conv_add : verify_program<test_conv_relu_conv_add>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+
+        migraphx::shape xs{migraphx::shape::float_type, {2, 20, 14, 14}};
+        migraphx::shape ws{migraphx::shape::float_type, {20, 20, 3, 3}};
+        auto x     = mm->add_parameter("x", xs);
+        auto w1    = mm->add_literal(migraphx::generate_literal(ws, 1));
+        auto w2    = mm->add_literal(migraphx::generate_literal(ws, 2));
+        auto conv1 = mm->add_instruction(
+            migraphx::make_op("convolution", {{"padding", {1, 1}}}), x, w1);
+        auto relu1 = mm->add_instruction(migraphx::make_op("relu"), conv1);
+        auto conv2 = mm->add_instruction(
+            migraphx::make_op("convolution", {{"padding", {1, 1}}}), relu1, w2);
+        auto add = mm->add_instruction(migraphx::make_op("add"), conv2, x);
+        mm->add_instruction(migraphx::make_op("relu"), add);
+        return p;
+    }
+};
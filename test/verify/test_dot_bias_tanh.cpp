@@ -0,0 +1,32 @@
+#include "verify_program.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/instruction.hpp>
+
+template <std::size_t M, std::size_t N, std::size_t K>
+struct test_dot_bias_tanh : verify_program<test_dot_bias_tanh<M, N, K>>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        migraphx::shape as{migraphx::shape::float_type, {2, M, K}};
+        migraphx::shape bs{migraphx::shape::float_type, {2, K, N}};
+        migraphx::shape cs{migraphx::shape::float_type, {N}};
+        auto a    = mm->add_parameter("a", as);
+        auto b    = mm->add_literal(migraphx::generate_literal(bs, 1));
+        auto c    = mm->add_literal(migraphx::generate_literal(cs, 2));
+        auto dot  = mm->add_instruction(migraphx::make_op("dot"), a, b);
+        auto bias = mm->add_instruction(
+            migraphx::make_op("broadcast", {{"axis", 2}, {"out_lens", dot->get_shape().lens()}}),
+            c);
+        auto add = mm->add_instruction(migraphx::make_op("add"), dot, bias);
+        mm->add_instruction(migraphx::make_op("tanh"), add);
+        return p;
+    }
+};
+
+template struct test_dot_bias_tanh<1, 8, 4>;
+template struct test_dot_bias_tanh<7, 33, 12>;
+template struct test_dot_bias_tanh<64, 64, 64>;
@@ -17,7 +17,8 @@
     m(int32_type, int32_t) \
     m(int64_type, int64_t) \
     m(uint32_type, uint32_t) \
-    m(uint64_type, uint64_t)
+    m(uint64_type, uint64_t) \
+    m(bf16_type, bf16)
 // clang-format on
 
 #ifdef __cplusplus